@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include "LazySequence.hpp"
+
+// the same source written both ways: a state machine in fields and a loop with co_yield
+class CountingGenerator : public IGenerator<long>
+{
+public:
+    CountingGenerator() : _next(0) {}
+public:
+    long getNext() override { return _next++; }
+    long get( const Ordinal& index ) override { return static_cast<long>( static_cast<size_t>( index )); }
+    bool hasNext() override { return true; }
+    Option<long> tryGetNext() override { return Option<long>( getNext() ); }
+private:
+    long _next;
+};
+
+static Coroutine<long> counting() {
+    for (long next = 0; ; next++) {
+        co_yield next;
+    }
+}
+
+static void virtualGetNext( benchmark::State& state ) {
+    UniquePtr<IGenerator<long>> gen = makeUnique<CountingGenerator>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( gen->getNext() );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+static void coroutineResume( benchmark::State& state ) {
+    auto coroutine = counting();
+    for (auto _ : state) {
+        coroutine.next();
+        benchmark::DoNotOptimize( coroutine.getValue() );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+static void coroutineGeneratorGetNext( benchmark::State& state ) {
+    UniquePtr<IGenerator<long>> gen = makeUnique<CoroutineGenerator<long>>( counting );
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( gen->getNext() );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+BENCHMARK(virtualGetNext);
+BENCHMARK(coroutineResume);
+BENCHMARK(coroutineGeneratorGetNext);
+
+BENCHMARK_MAIN();
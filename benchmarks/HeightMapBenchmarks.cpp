@@ -0,0 +1,19 @@
+#include <benchmark/benchmark.h>
+#include "HeightMapGenerator.hpp"
+
+template <ChunkKernel kernel>
+static void nextChunk( benchmark::State& state ) {
+    HeightMapGenerator gen( 0.0f, state.range(0), 1.0f, 42 );
+    gen.setKernel( kernel );
+    for (auto _ : state) {
+        auto res = gen.getNext();
+        benchmark::DoNotOptimize( res.getData() );
+    }
+    state.counters["chunks/s"] = benchmark::Counter( state.iterations(), benchmark::Counter::kIsRate );
+    state.SetItemsProcessed( state.iterations() * state.range(0) * state.range(0) );
+}
+
+BENCHMARK_TEMPLATE(nextChunk, ChunkKernel::ROW_MAJOR)->RangeMultiplier(2)->Range(16, 1024);
+BENCHMARK_TEMPLATE(nextChunk, ChunkKernel::WAVEFRONT)->RangeMultiplier(2)->Range(16, 1024);
+
+BENCHMARK_MAIN();
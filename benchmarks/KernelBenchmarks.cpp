@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "BatchKernels.hpp"
+
+template <typename T>
+static std::vector<T> randomData( const size_t size ) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int32_t> dist(-1000, 1000);
+    std::vector<T> res(size);
+    for (auto& value : res) {
+        value = static_cast<T>( dist(gen) );
+    }
+    return res;
+}
+
+// the same buffer is mapped every iteration, so the factor is -1: any other one would overflow the ints
+// after a few iterations, which is undefined in the scalar path
+template <typename T, KernelIsa isa>
+static void mapKernel( benchmark::State& state ) {
+    auto data = randomData<T>( state.range(0) );
+    auto op = ArithmeticOp<T>::mul( static_cast<T>(-1) );
+    for (auto _ : state) {
+        BatchKernels<T>::map( data.data(), data.size(), op, isa );
+        benchmark::DoNotOptimize( data.data() );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+template <typename T, KernelIsa isa>
+static void whereKernel( benchmark::State& state ) {
+    auto source = randomData<T>( state.range(0) );
+    auto data = source;
+    auto op = ComparisonOp<T>::greater( static_cast<T>(0) );
+    for (auto _ : state) {
+        state.PauseTiming();
+        data = source;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize( BatchKernels<T>::where( data.data(), data.size(), op, isa ));
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+// the same loop through std::function, which is what map/where cost without kernels
+template <typename T>
+static void mapFunction( benchmark::State& state ) {
+    auto data = randomData<T>( state.range(0) );
+    std::function<T(T)> func = []( T value ) { return value * static_cast<T>(-1); };
+    for (auto _ : state) {
+        for (auto& value : data) {
+            value = func( value );
+        }
+        benchmark::DoNotOptimize( data.data() );
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+BENCHMARK_TEMPLATE(mapKernel, int32_t, KernelIsa::SCALAR)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapKernel, int32_t, KernelIsa::SSE2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapKernel, int32_t, KernelIsa::AVX2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapKernel, float, KernelIsa::SCALAR)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapKernel, float, KernelIsa::SSE2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapKernel, float, KernelIsa::AVX2)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(whereKernel, int32_t, KernelIsa::SCALAR)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(whereKernel, int32_t, KernelIsa::SSE2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(whereKernel, int32_t, KernelIsa::AVX2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(whereKernel, float, KernelIsa::SCALAR)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(whereKernel, float, KernelIsa::SSE2)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(whereKernel, float, KernelIsa::AVX2)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(mapFunction, int32_t)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(mapFunction, float)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_MAIN();
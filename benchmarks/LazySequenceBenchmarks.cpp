@@ -0,0 +1,171 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "LazySequence.hpp"
+
+static SharedPtr<LazySequence<int>> naturals() {
+    ArraySequence<int> initial;
+    initial.append(0);
+    return LazySequence<int>::create( 1, []( ArraySequence<int>& window ) { return window[0] + 1; }, initial );
+}
+
+static SharedPtr<LazySequence<int>> firstNaturals( const size_t size ) {
+    ArraySequence<int> data;
+    for (size_t index = 0; index < size; index++) {
+        data.append( static_cast<int>( index ));
+    }
+    return LazySequence<int>::create( data );
+}
+
+// the index keeps growing, so the cache reaches CACHE_MAX_SIZE and is trimmed back to CACHE_DECREASE_SIZE every 1'000 elements
+static void indexSequential( benchmark::State& state ) {
+    auto seq = naturals();
+    size_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( (*seq)[Ordinal( index++ )] );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+// the whole sequence fits into the cache, so every access after the first pass is a hit
+static void indexRandom( benchmark::State& state ) {
+    const size_t size = static_cast<size_t>( state.range(0) );
+    auto seq = firstNaturals( size );
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> dist( 0, size - 1 );
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( (*seq)[Ordinal( dist( rng ))] );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+// same walk as indexSequential through a cursor, which pulls STREAM_BATCH elements per refill
+static void streamSequential( benchmark::State& state ) {
+    auto seq = naturals();
+    auto stream = seq->stream();
+    auto cursor = stream.begin();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( *cursor );
+        ++cursor;
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+static void memoiseStreaming( benchmark::State& state ) {
+    auto seq = naturals();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( seq->memoiseNext() );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+enum class Chain { APPEND, PREPEND, INSERT };
+
+// every element of a chain of depth d is pulled through d generators
+template <Chain chain>
+static void chainTraversal( benchmark::State& state ) {
+    const int depth = static_cast<int>( state.range(0) );
+    for (auto _ : state) {
+        auto seq = firstNaturals( 16 );
+        for (int level = 0; level < depth; level++) {
+            switch (chain) {
+            case Chain::APPEND:  seq = seq->append( level ); break;
+            case Chain::PREPEND: seq = seq->prepend( level ); break;
+            case Chain::INSERT:  seq = seq->insertAt( level, Ordinal(8) ); break;
+            }
+        }
+        while (seq->canMemoiseNext()) {
+            benchmark::DoNotOptimize( seq->memoiseNext() );
+        }
+    }
+    state.SetItemsProcessed( state.iterations() * (16 + depth) );
+}
+
+static void mapFoldl( benchmark::State& state ) {
+    const size_t size = static_cast<size_t>( state.range(0) );
+    for (auto _ : state) {
+        auto mapped = firstNaturals( size )->map<int>( []( int x ) { return x * 3; } );
+        benchmark::DoNotOptimize( mapped->foldl<long>( []( long acc, int x ) { return acc + x; }, 0 ));
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+// where doesn't know its ordinality, so the filtered sequence is drained instead of folded
+static void mapWhere( benchmark::State& state ) {
+    const size_t size = static_cast<size_t>( state.range(0) );
+    for (auto _ : state) {
+        auto filtered = firstNaturals( size )->map<int>( []( int x ) { return x * 3; } )
+                                      ->where( []( int x ) { return x % 2 == 0; } );
+        long sum = 0;
+        while (auto next = filtered->tryMemoiseNext()) {
+            sum += next.get();
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+static void fibonacciGet( benchmark::State& state ) {
+    for (auto _ : state) {
+        ArraySequence<unsigned long> initial;
+        initial.append(0);
+        initial.append(1);
+        auto fib = LazySequence<unsigned long>::create( 2, []( ArraySequence<unsigned long>& window ) {
+            return window[0] + window[1];
+        }, initial );
+        benchmark::DoNotOptimize( fib->get( Ordinal( static_cast<size_t>( state.range(0) ))));
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+// the cost per element shouldn't grow with the width
+static void rollingMax( benchmark::State& state ) {
+    auto maximums = naturals()->rollingMax( static_cast<size_t>( state.range(0) ));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize( maximums->memoiseNext() );
+    }
+    state.SetItemsProcessed( state.iterations() );
+}
+
+// a csv of range(0) numbers, parsed in full every iteration. the file stays in the page cache, so this is the parsing throughput
+static void textIngestion( benchmark::State& state ) {
+    const size_t count = static_cast<size_t>( state.range(0) );
+    const std::string path = (std::filesystem::temp_directory_path() / "lazy_sequence_ingestion.csv").string();
+    {
+        std::ofstream out( path );
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> dist( -1000.0, 1000.0 );
+        for (size_t index = 0; index < count; index++) {
+            out << dist( rng ) << (index % 16 == 15 ? '\n' : ',');
+        }
+    }
+    size_t bytes = static_cast<size_t>( std::ifstream( path, std::ios::ate | std::ios::binary ).tellg() );
+    for (auto _ : state) {
+        auto seq = LazySequence<double>::fromText( path );
+        double sum = 0.0;
+        while (seq->canMemoiseNext()) {
+            sum += seq->memoiseNext();
+        }
+        benchmark::DoNotOptimize( sum );
+    }
+    std::remove( path.c_str() );
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+    state.SetBytesProcessed( static_cast<int64_t>( state.iterations() * bytes ));
+}
+
+BENCHMARK(indexSequential);
+BENCHMARK(indexRandom)->Arg(1'000);
+BENCHMARK(streamSequential);
+BENCHMARK(memoiseStreaming);
+BENCHMARK_TEMPLATE(chainTraversal, Chain::APPEND)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK_TEMPLATE(chainTraversal, Chain::PREPEND)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK_TEMPLATE(chainTraversal, Chain::INSERT)->RangeMultiplier(4)->Range(4, 256);
+BENCHMARK(mapFoldl)->Arg(1'000);
+BENCHMARK(mapWhere)->Arg(1'000);
+BENCHMARK(fibonacciGet)->RangeMultiplier(8)->Range(64, 4096);
+BENCHMARK(rollingMax)->RangeMultiplier(8)->Range(8, 4096);
+BENCHMARK(textIngestion)->Arg(1'000'000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+#include "DynamicArray.hpp"
+#include "SharedPtr.hpp"
+#include "SharedFromThis.hpp"
+
+static void dynamicArrayAppend( benchmark::State& state ) {
+    for (auto _ : state) {
+        DynamicArray<int> array;
+        for (int index = 0; index < state.range(0); index++) {
+            array.append( index );
+        }
+        benchmark::DoNotOptimize( array.getData() );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+static void dynamicArrayInsertMiddle( benchmark::State& state ) {
+    for (auto _ : state) {
+        DynamicArray<int> array;
+        for (int index = 0; index < state.range(0); index++) {
+            array.insertAt( index, array.getSize() / 2 );
+        }
+        benchmark::DoNotOptimize( array.getData() );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+static void dynamicArrayRemoveFront( benchmark::State& state ) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        DynamicArray<int> array;
+        for (int index = 0; index < state.range(0); index++) {
+            array.append( index );
+        }
+        state.ResumeTiming();
+        while (!array.isEmpty()) {
+            array.removeAt(0);
+        }
+        benchmark::DoNotOptimize( array.getData() );
+    }
+    state.SetItemsProcessed( state.iterations() * state.range(0) );
+}
+
+struct Node : public EnableSharedFromThis<Node>
+{
+    int value = 0;
+};
+
+static void sharedPtrCopy( benchmark::State& state ) {
+    auto ptr = makeShared<Node>();
+    for (auto _ : state) {
+        SharedPtr<Node> copy( ptr );
+        benchmark::DoNotOptimize( copy );
+    }
+}
+
+static void sharedPtrMove( benchmark::State& state ) {
+    auto ptr = makeShared<Node>();
+    for (auto _ : state) {
+        SharedPtr<Node> moved( std::move( ptr ));
+        ptr = std::move( moved );
+        benchmark::DoNotOptimize( ptr );
+    }
+}
+
+static void sharedFromThis( benchmark::State& state ) {
+    auto ptr = makeShared<Node>();
+    for (auto _ : state) {
+        auto self = ptr->sharedFromThis();
+        benchmark::DoNotOptimize( self );
+    }
+}
+
+BENCHMARK(dynamicArrayAppend)->RangeMultiplier(8)->Range(64, 32'768);
+BENCHMARK(dynamicArrayInsertMiddle)->RangeMultiplier(8)->Range(64, 4'096);
+BENCHMARK(dynamicArrayRemoveFront)->RangeMultiplier(8)->Range(64, 4'096);
+BENCHMARK(sharedPtrCopy);
+BENCHMARK(sharedPtrMove);
+BENCHMARK(sharedFromThis);
+
+BENCHMARK_MAIN();
@@ -43,6 +43,9 @@ public:
 public:
     bool isEmpty() const override;
     size_t getSize() const override;
+
+    T* getData();
+    const T* getData() const;
 public:
     Sequence<T>* appendImmutable( const T& value ) const override;
     Sequence<T>* prependImmutable( const T& value ) const override;
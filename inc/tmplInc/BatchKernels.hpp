@@ -0,0 +1,117 @@
+#ifndef BATCH_KERNELS_H
+#define BATCH_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define BATCH_KERNELS_X86
+#endif
+
+// elementwise operations which batch kernels know how to vectorize.
+// wrapping them into std::function keeps them recognizable, so map/where pick the vectorized path automatically
+template <typename T>
+class ArithmeticOp
+{
+public:
+    enum class Kind {
+        ADD = 0,
+        SUB = 1,
+        MUL = 2
+    };
+public:
+    ArithmeticOp( const Kind kind, const T& operand ) : _kind( kind ), _operand( operand ) {}
+
+    ArithmeticOp( const ArithmeticOp<T>& other ) = default;
+    ArithmeticOp<T>& operator=( const ArithmeticOp<T>& other ) = default;
+
+    ~ArithmeticOp() = default;
+public:
+    static ArithmeticOp<T> add( const T& operand ) { return ArithmeticOp<T>( Kind::ADD, operand ); }
+    static ArithmeticOp<T> sub( const T& operand ) { return ArithmeticOp<T>( Kind::SUB, operand ); }
+    static ArithmeticOp<T> mul( const T& operand ) { return ArithmeticOp<T>( Kind::MUL, operand ); }
+public:
+    T operator()( T value ) const;
+
+    Kind getKind() const { return _kind; }
+    const T& getOperand() const { return _operand; }
+private:
+    Kind _kind;
+    T _operand;
+};
+
+template <typename T>
+class ComparisonOp
+{
+public:
+    enum class Kind {
+        LESS = 0,
+        LESS_EQUAL = 1,
+        GREATER = 2,
+        GREATER_EQUAL = 3,
+        EQUAL = 4,
+        NOT_EQUAL = 5
+    };
+public:
+    ComparisonOp( const Kind kind, const T& operand ) : _kind( kind ), _operand( operand ) {}
+
+    ComparisonOp( const ComparisonOp<T>& other ) = default;
+    ComparisonOp<T>& operator=( const ComparisonOp<T>& other ) = default;
+
+    ~ComparisonOp() = default;
+public:
+    static ComparisonOp<T> less( const T& operand )         { return ComparisonOp<T>( Kind::LESS, operand ); }
+    static ComparisonOp<T> lessEqual( const T& operand )    { return ComparisonOp<T>( Kind::LESS_EQUAL, operand ); }
+    static ComparisonOp<T> greater( const T& operand )      { return ComparisonOp<T>( Kind::GREATER, operand ); }
+    static ComparisonOp<T> greaterEqual( const T& operand ) { return ComparisonOp<T>( Kind::GREATER_EQUAL, operand ); }
+    static ComparisonOp<T> equal( const T& operand )        { return ComparisonOp<T>( Kind::EQUAL, operand ); }
+    static ComparisonOp<T> notEqual( const T& operand )     { return ComparisonOp<T>( Kind::NOT_EQUAL, operand ); }
+public:
+    bool operator()( T value ) const;
+
+    Kind getKind() const { return _kind; }
+    const T& getOperand() const { return _operand; }
+private:
+    Kind _kind;
+    T _operand;
+};
+
+enum class KernelIsa {
+    SCALAR = 0,
+    SSE2 = 1,
+    AVX2 = 2
+};
+
+// in-place batch kernels over contiguous buffers.
+// only int32_t and float have vector paths, the rest of arithmetic types run the scalar loop
+template <typename T>
+class BatchKernels
+{
+public:
+    static constexpr bool isVectorizable = std::is_same_v<T, int32_t> || std::is_same_v<T, float>;
+
+    static KernelIsa getBestIsa();
+public:
+    static void map( T* data, const size_t size, const ArithmeticOp<T>& op );
+    static void map( T* data, const size_t size, const ArithmeticOp<T>& op, const KernelIsa isa );
+
+    // stable compaction of the elements satisfying op, returns the amount of elements kept
+    static size_t where( T* data, const size_t size, const ComparisonOp<T>& op );
+    static size_t where( T* data, const size_t size, const ComparisonOp<T>& op, const KernelIsa isa );
+
+    // run the kernel only if func wraps one of the known operations, report whether it happened
+    template <typename Signature>
+    static bool tryMap( T* data, const size_t size, const std::function<Signature>& func );
+    template <typename Signature>
+    static bool tryWhere( T* data, size_t& size, const std::function<Signature>& func );
+private:
+    static void mapScalar( T* data, const size_t size, const ArithmeticOp<T>& op );
+    static size_t whereScalar( T* data, const size_t size, const ComparisonOp<T>& op );
+};
+
+#include "BatchKernels.tpp"
+
+#endif // BATCH_KERNELS_H
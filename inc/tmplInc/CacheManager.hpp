@@ -0,0 +1,94 @@
+#ifndef CACHE_MANAGER_H
+#define CACHE_MANAGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "ArraySequence.hpp"
+
+struct CacheFootprint
+{
+    const void* owner = nullptr;
+    std::string generator;
+    size_t cached = 0;         // elements
+    size_t cacheBytes = 0;     // as charged against the budget
+    size_t generatorBytes = 0; // state held by the generator itself, e.g. a window or a memoized element
+    size_t spilledBytes = 0;   // evicted elements kept on disk, not counted against the budget
+};
+
+class CacheManager;
+
+// a cache known to the manager. it registers itself on construction and leaves on destruction,
+// the owner reports the size of its cache with update() and gives memory back through evictOldest()
+class CacheEntry
+{
+public:
+    CacheEntry( const CacheEntry& other ) = delete;
+    CacheEntry& operator=( const CacheEntry& other ) = delete;
+
+    virtual ~CacheEntry();
+public:
+    void update( const size_t bytes ); // also marks the cache as recently used
+    size_t getBytes() const { return _bytes.load( std::memory_order_relaxed ); }
+
+    virtual size_t evictOldest( const size_t bytes ) = 0; // frees about that many bytes, returns the freed amount
+    virtual const void* getOwner() const = 0;
+    virtual CacheFootprint getFootprint() const = 0; // reads the owner, so only the thread using the cache may call it
+protected:
+    CacheEntry();
+private:
+    friend class CacheManager;
+    std::atomic<size_t> _bytes;
+    std::atomic<bool> _referenced;
+    std::atomic<std::thread::id> _thread; // the last thread which used the cache, the only one allowed to evict it
+    CacheEntry* _prev;
+    CacheEntry* _next;
+};
+
+// process-wide byte budget for the caches of all sequences. once the registered caches exceed it, the oldest
+// elements of the least recently used caches are evicted (CLOCK over the caches). a budget of zero means unlimited.
+// eviction turns the evicted elements into dematerialized ones, exactly as the per-sequence trim does
+class CacheManager
+{
+public:
+    static CacheManager& instance();
+
+    CacheManager( const CacheManager& other ) = delete;
+    CacheManager& operator=( const CacheManager& other ) = delete;
+
+    ~CacheManager() = default;
+public:
+    size_t getBudget() const { return _budget.load( std::memory_order_relaxed ); }
+    void setBudget( const size_t bytes ); // evicts right away if needed
+
+    size_t getBytes() const { return _bytes.load( std::memory_order_relaxed ); }
+    size_t getCount() const;
+    size_t getEvictions() const { return _evictions.load( std::memory_order_relaxed ); }
+    size_t getEvictedBytes() const { return _evictedBytes.load( std::memory_order_relaxed ); }
+
+    // footprints of the caches the calling thread uses, other caches are reported with their owner and charged bytes only
+    ArraySequence<CacheFootprint> report() const;
+private:
+    CacheManager();
+
+    friend class CacheEntry;
+    void enroll( CacheEntry* entry );
+    void withdraw( CacheEntry* entry );
+    void charge( const size_t oldBytes, const size_t newBytes );
+    void enforce();
+private:
+    mutable std::mutex _lock;
+    CacheEntry* _head;
+    CacheEntry* _hand; // the next cache the clock looks at
+    size_t _count;
+    std::atomic<size_t> _budget;
+    std::atomic<size_t> _bytes;
+    std::atomic<size_t> _evictions;
+    std::atomic<size_t> _evictedBytes;
+};
+
+#include "CacheManager.tpp"
+
+#endif // CACHE_MANAGER_H
@@ -0,0 +1,37 @@
+#ifndef COROUTINE_GENERATOR_H
+#define COROUTINE_GENERATOR_H
+
+#include <functional>
+#include "Generator.hpp"
+#include "Coroutine.hpp"
+
+// generator whose elements are produced by a coroutine body written as a plain loop with co_yield.
+// the body is kept to start it anew for random access, so it has to yield the same elements on every run
+// and whatever it captures by reference has to outlive the generator
+template <typename T>
+class CoroutineGenerator : public IGenerator<T>
+{
+public:
+    CoroutineGenerator( const std::function<Coroutine<T>()>& body );
+
+    CoroutineGenerator( const CoroutineGenerator<T>& other );
+    CoroutineGenerator<T>& operator=( const CoroutineGenerator<T>& other );
+
+    CoroutineGenerator( CoroutineGenerator<T>&& other );
+    CoroutineGenerator<T>& operator=( CoroutineGenerator<T>&& other );
+
+    ~CoroutineGenerator() = default;
+public:
+    T getNext() override;
+    T get( const Ordinal& index ) override; // replays a fresh run of the body up to the index
+    bool hasNext() override;
+    Option<T> tryGetNext() override;
+private:
+    SharedPtr<std::function<Coroutine<T>()>> _body; // running bodies refer to their captures, so the callable never moves
+    Coroutine<T> _coroutine; // destroyed before the body it might refer to
+    bool _isSuspended; // the body is suspended on a value which hasn't been returned yet
+};
+
+#include "CoroutineGenerator.tpp"
+
+#endif // COROUTINE_GENERATOR_H
@@ -2,6 +2,7 @@
 #define DYNAMIC_ARRAY_H
 
 #include "util.hpp"
+#include "BatchKernels.hpp"
 #include <functional>
 
 template <typename T> 
@@ -37,6 +38,10 @@ public:
 public:
     size_t getSize() const;
     bool isEmpty() const;
+
+    // contiguous storage of the elements, invalidated by any operation changing the size
+    T* getData();
+    const T* getData() const;
 public:
     DynamicArray<T>* appendImmutable( const T& value ) const;
     DynamicArray<T>* prependImmutable( const T& value ) const;
@@ -48,6 +53,7 @@ public:
     DynamicArray<T>* mapImmutable( const std::function<T(T)>& func ) const;
     DynamicArray<T>* whereImmutable( const std::function<bool(T)>& func ) const;
 public:
+    // both run batch kernels when func wraps ArithmeticOp/ComparisonOp
     void map( const std::function<T(T&)>& func );
     void where( const std::function<bool(T)>& func );
 private:
@@ -6,6 +6,11 @@
 #include "ArraySequence.hpp"
 #include "Ordinal.hpp"
 #include "SharedPtr.hpp"
+#include "ScanBudget.hpp"
+#include "Pipeline.hpp"
+#include "Trace.hpp"
+#include "Snapshot.hpp"
+#include "ParentCursor.hpp"
 
 template <typename T>
 class LazySequence;
@@ -20,6 +25,27 @@ public:
     virtual T get( const Ordinal& index ) = 0;
     virtual bool hasNext() = 0;
     virtual Option<T> tryGetNext() = 0;
+    virtual bool isRandomAccess() const { return false; } // get() is as cheap as reading a cached element
+    virtual bool canRevisit() const { return isRandomAccess(); } // get() indexes the same way as the sequence, behind its cache too
+    virtual Option<Ordinal> getOrdinality() const { return Option<Ordinal>(); } // for generators which find their end while running
+    // whether the next element can be pulled. where generators up the pipeline stop scanning for it once budget runs out,
+    // their own budgets apply without one. hasNext() throws SCAN_BUDGET_EXHAUSTED in that case, as a bool can't tell
+    virtual ScanStatus scan( const Option<ScanBudget>& budget );
+public: // introspection of the pipeline, see LazySequence::explain()
+    virtual std::string getName() const; // the demangled type by default
+    virtual void visitParents( PipelineVisitor& visitor ) const; // generators pulling from other sequences visit them
+    virtual double getPullFactor() const; // parent elements pulled per element
+    virtual size_t getStateBytes() const; // elements and bookkeeping held by the generator itself, parents excluded
+public: // snapshots, see LazySequence::save(). generators pulling from other sequences save them too
+    virtual void saveState( SnapshotWriter& out ) const; // throws UNSUPPORTED_SNAPSHOT by default
+    virtual void restoreState( SnapshotReader& in );
+#ifdef LAZY_SEQUENCE_COUNTERS
+public:
+    virtual void addCounters( SequenceCounters& total ) const { total += _counters; }
+    void resetCounters() { _counters = SequenceCounters(); }
+protected:
+    SequenceCounters _counters;
+#endif
 };
     
 template <typename T>
@@ -43,6 +69,9 @@ public:
     T get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<T> tryGetNext() override;
+    size_t getStateBytes() const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     ArraySequence<T> _data;
@@ -66,6 +95,9 @@ public:
     T get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<T> tryGetNext() override;
+    size_t getStateBytes() const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _arity;
     size_t _lastMaterialized;
@@ -91,12 +123,16 @@ public:
     T getNext() override;
     T get( const Ordinal& index ) override;
     bool hasNext() override;
+    ScanStatus scan( const Option<ScanBudget>& budget ) override;
     Option<T> tryGetNext() override;
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     Option<Ordinal> _border;
-    SharedPtr<LazySequence<T>> _initial;
-    SharedPtr<LazySequence<T>> _added;
+    ParentCursor<T> _initial;
+    ParentCursor<T> _added;
 };
 
 template <typename T>
@@ -117,12 +153,16 @@ public:
     T getNext() override;
     T get( const Ordinal& index ) override;
     bool hasNext() override;
+    ScanStatus scan( const Option<ScanBudget>& budget ) override;
     Option<T> tryGetNext() override;    
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     Option<Ordinal> _border;
-    SharedPtr<LazySequence<T>> _initial;
-    SharedPtr<LazySequence<T>> _added;
+    ParentCursor<T> _initial;
+    ParentCursor<T> _added;
 };
 
 template <typename T>
@@ -144,12 +184,15 @@ public:
     T get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<T> tryGetNext() override;
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     Ordinal _targetIndex;
     Option<Ordinal> _border;
-    SharedPtr<LazySequence<T>> _initial;
-    SharedPtr<LazySequence<T>> _added;
+    ParentCursor<T> _initial;
+    ParentCursor<T> _added;
 };
 
 template <typename T>
@@ -171,11 +214,14 @@ public:
     T get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<T> tryGetNext() override; 
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     Ordinal _from;
     Ordinal _to;
-    SharedPtr<LazySequence<T>> _parent;
+    ParentCursor<T> _parent;
 };
 
 template <typename T>
@@ -196,11 +242,14 @@ public:
     T get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<T> tryGetNext() override;
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     size_t _lastMaterialized;
     Ordinal _from;
     Ordinal _to;
-    SharedPtr<LazySequence<T>> _parent;
+    ParentCursor<T> _parent;
 };
 
 template <typename T>
@@ -220,11 +269,15 @@ public:
     T getNext() override;
     T get( const Ordinal& index ) override;
     bool hasNext() override;
+    ScanStatus scan( const Option<ScanBudget>& budget ) override;
     Option<T> tryGetNext() override;   
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     Option<Ordinal> _border;
-    SharedPtr<LazySequence<T>> _first;
-    SharedPtr<LazySequence<T>> _second;
+    ParentCursor<T> _first;
+    ParentCursor<T> _second;
 };
 
 template <typename TIn, typename TOut>
@@ -244,17 +297,21 @@ public:
     TOut getNext() override;
     TOut get( const Ordinal& index ) override;
     bool hasNext() override;
+    ScanStatus scan( const Option<ScanBudget>& budget ) override;
     Option<TOut> tryGetNext() override;   
+    void visitParents( PipelineVisitor& visitor ) const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
 private:
     std::function<TOut(TIn)> _func;
-    SharedPtr<LazySequence<TIn>> _parent;
+    ParentCursor<TIn> _parent;
 };
 
 template <typename T>
 class WhereGenerator : public IGenerator<T>
 {
 public:
-    WhereGenerator( const std::function<bool(T)>& func, SharedPtr<LazySequence<T>> parent );
+    WhereGenerator( const std::function<bool(T)>& func, SharedPtr<LazySequence<T>> parent, const ScanBudget& budget = ScanBudget() );
     
     WhereGenerator( const WhereGenerator& other );
     WhereGenerator& operator=( const WhereGenerator& other );
@@ -265,14 +322,34 @@ public:
     ~WhereGenerator() = default;
 public:
     T getNext() override;
-    T get( const Ordinal& index ) override;
+    T get( const Ordinal& index ) override; // scanned elements are read from the parent by their recorded positions
     bool hasNext() override;
-    Option<T> tryGetNext() override;   
+    Option<T> tryGetNext() override;
+    bool canRevisit() const override { return true; }
+    ScanStatus scan( const Option<ScanBudget>& budget ) override; // within budget or the generator's own one
+    void visitParents( PipelineVisitor& visitor ) const override;
+public:
+    double getPullFactor() const override; // measured on the elements accepted so far
+    size_t getStateBytes() const override;
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
+public:
+    const ScanBudget& getBudget() const;
+    void setBudget( const ScanBudget& budget );
+private:
+    ScanStatus scanNext( ScanBudget::Meter& meter, const Option<ScanBudget>& budget ); // budget goes to the parent
+    void ensureScanned( const size_t count );
+    void trimPositions(); // drops the oldest emitted positions once there are more than POSITIONS_MAX_SIZE
+    size_t getScannedCount() const; // positions recorded so far, trimmed ones included
 private:
+    static const size_t POSITIONS_MAX_SIZE = 8'192;
     std::function<bool(T)> _predicate;
-    SharedPtr<LazySequence<T>> _parent;
+    ParentCursor<T> _parent;
     Option<T> _memoized; // need to remember an element since both hasNext() and getNext() are changing the state of parent generator and valid elements can become lost
-    bool _isFinished;
+    ArraySequence<size_t> _positions; // parent indices of the accepted elements, in order of acceptance
+    size_t _dropped; // oldest positions trimmed from _positions, see trimPositions()
+    size_t _emitted;
+    ScanBudget _budget; // applied to every hasNext()/getNext()/get() call
 };
 
 #include "Generator.tpp"
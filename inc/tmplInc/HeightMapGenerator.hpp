@@ -2,19 +2,31 @@
 #define HMAP_GEN_H
 
 #include "Generator.hpp"
-#include <random>
+#include "Tile.hpp"
+#include "CounterRng.hpp"
+#include "BatchKernels.hpp"
 
-using chunk = ArraySequence<ArraySequence<float>>;
+using chunk = Tile<>;
 using column = ArraySequence<float>;
 
+enum class ChunkKernel {
+    ROW_MAJOR = 0,
+    WAVEFRONT = 1 // whole anti-diagonals at once, needs avx2. falls back to ROW_MAJOR without it and for small chunks
+};
+
+static const size_t WAVEFRONT_MIN_SIZE = 32;
+
+// chunks are fully determined by the seed and their index: noise of every cell is a counter-based hash,
+// and the left edge of every checkpointInterval-th chunk is remembered once it has been computed.
+// this makes get( index ) reproducible and lets chunks of distinct checkpoint segments be generated in parallel
 class HeightMapGenerator : public IGenerator<chunk>
 {
 public:
     HeightMapGenerator();
-    HeightMapGenerator( const column& seed, const size_t size = 16, const float amp = 1.0f );
-    HeightMapGenerator( const float begin, const size_t size = 16, const float amp = 1.0f );
-    
-    
+    HeightMapGenerator( const column& seed, const size_t size = 16, const float amp = 1.0f, const uint64_t rngSeed = CounterRng::randomSeed() );
+    HeightMapGenerator( const float begin, const size_t size = 16, const float amp = 1.0f, const uint64_t rngSeed = CounterRng::randomSeed() );
+
+
     HeightMapGenerator( const HeightMapGenerator& other ) = default;
     HeightMapGenerator& operator=( const HeightMapGenerator& other ) = default;
 
@@ -27,18 +39,55 @@ public:
     chunk get( const Ordinal& index ) override;
     bool hasNext() override;
     Option<chunk> tryGetNext() override;
+    size_t getStateBytes() const override; // the previous edge and the checkpoints
+    void saveState( SnapshotWriter& out ) const override; // everything, a default constructed generator can be restored
+    void restoreState( SnapshotReader& in ) override;
+public:
+    // same as getNext(), but with the side known at compile time. size of the generator must be N
+    template <size_t N>
+    Tile<N> nextTile();
+
+    // chunks [first, first + count). checkpoint segments are split between threads, 0 threads means hardware concurrency
+    ArraySequence<chunk> getRange( const size_t first, const size_t count, const size_t threads = 0 );
+public:
+    uint64_t getSeed() const { return _rng.getSeed(); }
+    size_t getSize() const { return _size; }
+    size_t getCheckpointInterval() const { return _checkpointInterval; }
+    void setCheckpointInterval( const size_t interval ); // drops checkpoints computed so far
+
+    // both kernels produce bitwise equal chunks, as long as the compiler is not allowed to fuse multiply-adds
+    ChunkKernel getKernel() const { return _kernel; }
+    void setKernel( const ChunkKernel kernel ) { _kernel = kernel; }
 private:
-    chunk nextChunk();
+    template <size_t N>
+    void fillTile( float* cells, const float* edge, const size_t index ) const;
+    void fill( float* cells, const float* edge, const size_t index ) const;
+    void fillWavefront( float* cells, const float* edge, const size_t index ) const;
+    void storeEdge( const float* cells, float* edge ) const;
+
+    column edgeBefore( const size_t index ); // left edge of the chunk, recomputed from the nearest checkpoint
+    void passChunk( const size_t index, const float* edge ); // records the checkpoint following the chunk, if it is the next one
 private:
     size_t _size;
-    Ordinal _lastMaterialized;
+    size_t _lastMaterialized;
     column _prevEdge;
 
-    
-    std::uniform_real_distribution<float> _dist;
-    std::mt19937 _rng;
+    CounterRng _rng;
+    float _scale;
+
+    size_t _checkpointInterval;
+    ArraySequence<column> _checkpoints; // left edges of chunks 0, interval, 2 * interval, ...
+    ChunkKernel _kernel;
+};
+
+// dynamic tiles are stored as their side followed by the cells
+template <>
+struct SnapshotCodec<chunk>
+{
+    static void write( SnapshotWriter& out, const chunk& value );
+    static chunk read( SnapshotReader& in );
 };
 
 #include "HeightMapGenerator.tpp"
 
-#endif // HMAP_GEN_H
\ No newline at end of file
+#endif // HMAP_GEN_H
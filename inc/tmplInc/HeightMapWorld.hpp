@@ -0,0 +1,74 @@
+#ifndef HMAP_WORLD_H
+#define HMAP_WORLD_H
+
+#include <cstdint>
+#include "HeightMapGenerator.hpp"
+#include "LruCache.hpp"
+#include "SharedPtr.hpp"
+
+struct TileCoord
+{
+    int64_t x;
+    int64_t y;
+
+    bool operator==( const TileCoord& other ) const { return x == other.x && y == other.y; }
+};
+
+struct TileCoordHash
+{
+    size_t operator()( const TileCoord& coord ) const {
+        return std::hash<uint64_t>()( static_cast<uint64_t>( coord.x ) * 0x9e3779b97f4a7c15ull ^ static_cast<uint64_t>( coord.y ));
+    }
+};
+
+// unbounded 2d height map made of size x size tiles, tile (x, y) being to the right of (x - 1, y) and below (x, y - 1).
+// neighbouring tiles never see each other: every tile boundary is a seam, a random walk between two corner values,
+// which is a function of the seed and its position only. tile interior continues its left and upper seams
+// and is then pulled towards its right and lower ones, so any tile can be generated alone and still fits all four neighbours.
+// corners spread around the base height, so the whole map does. generated tiles are kept in an lru cache bounded in bytes
+class HeightMapWorld
+{
+public:
+    HeightMapWorld( const uint64_t seed, const size_t size = 16, const float amp = 1.0f, const size_t cacheCapacity = DEFAULT_CACHE_CAPACITY
+                  , const float base = 0.0f );
+
+    HeightMapWorld( const HeightMapWorld& other ) = default;
+    HeightMapWorld& operator=( const HeightMapWorld& other ) = default;
+
+    HeightMapWorld( HeightMapWorld&& other ) = default;
+    HeightMapWorld& operator=( HeightMapWorld&& other ) = default;
+
+    ~HeightMapWorld() = default;
+public:
+    SharedPtr<chunk> get( const int64_t x, const int64_t y ); // stays valid after being evicted from the cache
+    chunk generate( const int64_t x, const int64_t y ) const; // bypasses the cache
+
+    float getHeight( const int64_t x, const int64_t y ); // single cell in world coordinates
+public:
+    uint64_t getSeed() const { return _rng.getSeed(); }
+    size_t getSize() const { return _size; }
+    float getBase() const { return _base; }
+
+    size_t getCacheCapacity() const { return _cache.getCapacity(); }
+    void setCacheCapacity( const size_t capacity ) { _cache.setCapacity( capacity ); }
+    const LruCache<TileCoord, SharedPtr<chunk>, TileCoordHash>& getCache() const { return _cache; }
+
+    static const size_t DEFAULT_CACHE_CAPACITY = 64 * 1024 * 1024;
+private:
+    float corner( const int64_t x, const int64_t y ) const;
+    // vertical seam left of tile (x, y) and horizontal seam above it
+    void verticalSeam( const int64_t x, const int64_t y, float* out ) const;
+    void horizontalSeam( const int64_t x, const int64_t y, float* out ) const;
+    void seam( const uint32_t streamKey, const float from, const float to, float* out ) const;
+private:
+    size_t _size;
+    float _scale;
+    float _cornerAmp;
+    float _base;
+    CounterRng _rng;
+    LruCache<TileCoord, SharedPtr<chunk>, TileCoordHash> _cache;
+};
+
+#include "HeightMapWorld.tpp"
+
+#endif // HMAP_WORLD_H
@@ -0,0 +1,120 @@
+#ifndef HMAP_WRITER_H
+#define HMAP_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "util.hpp"
+#include "UniquePtr.hpp"
+
+enum class HeightMapFormat {
+    RAW = 0, // little-endian float32 with a 24-byte header
+    PGM = 1, // binary 16-bit graymap
+    PNG = 2, // 16-bit grayscale, deflate stored without compression
+    CSV = 3
+};
+
+// heights mapped to the whole range of integer formats, values outside of it are clamped
+struct HeightRange
+{
+    float low;
+    float high;
+};
+
+// writes a height map row by row, so only a single row has to be kept in memory.
+// the dimensions are fixed up front: image headers need them before the first pixel
+class IHeightMapWriter
+{
+public:
+    virtual ~IHeightMapWriter() = default;
+
+    virtual void writeRow( const float* row ) = 0; // exactly getWidth() values
+    virtual void finish() = 0; // flushes the trailer, expects all getHeight() rows to be written
+
+    virtual size_t getWidth() const = 0;
+    virtual size_t getHeight() const = 0;
+};
+
+class HeightMapWriterBase : public IHeightMapWriter
+{
+public:
+    HeightMapWriterBase( const std::string& path, const size_t width, const size_t height );
+
+    HeightMapWriterBase( const HeightMapWriterBase& other ) = delete;
+    HeightMapWriterBase& operator=( const HeightMapWriterBase& other ) = delete;
+
+    virtual ~HeightMapWriterBase() = default;
+public:
+    size_t getWidth() const override { return _width; }
+    size_t getHeight() const override { return _height; }
+protected:
+    void beginRow(); // counts rows and rejects the ones past the height
+    void checkFinished() const;
+    void flush( const std::string& bytes );
+
+    static uint16_t quantize( const float value, const HeightRange& range );
+protected:
+    std::ofstream _out;
+    size_t _width;
+    size_t _height;
+    size_t _rowsWritten;
+    std::string _buffer; // one encoded row, reused between rows
+};
+
+class RawHeightMapWriter : public HeightMapWriterBase
+{
+public:
+    RawHeightMapWriter( const std::string& path, const size_t width, const size_t height );
+public:
+    void writeRow( const float* row ) override;
+    void finish() override;
+public:
+    static const uint32_t VERSION = 1; // header: "HMAP", u32 version, u64 width, u64 height
+};
+
+class PgmHeightMapWriter : public HeightMapWriterBase
+{
+public:
+    PgmHeightMapWriter( const std::string& path, const size_t width, const size_t height, const HeightRange& range );
+public:
+    void writeRow( const float* row ) override;
+    void finish() override;
+private:
+    HeightRange _range;
+};
+
+// zlib stream of stored deflate blocks split into one IDAT chunk per row,
+// checksums are updated on the fly so nothing but the current row is buffered
+class PngHeightMapWriter : public HeightMapWriterBase
+{
+public:
+    PngHeightMapWriter( const std::string& path, const size_t width, const size_t height, const HeightRange& range );
+public:
+    void writeRow( const float* row ) override;
+    void finish() override;
+private:
+    void writeChunk( const char* type, const std::string& data );
+
+    static uint32_t crc32( const uint32_t crc, const char* data, const size_t size );
+    static uint32_t adler32( const uint32_t adler, const char* data, const size_t size );
+private:
+    HeightRange _range;
+    uint32_t _adler;
+    std::string _scanline;
+};
+
+class CsvHeightMapWriter : public HeightMapWriterBase
+{
+public:
+    CsvHeightMapWriter( const std::string& path, const size_t width, const size_t height );
+public:
+    void writeRow( const float* row ) override;
+    void finish() override;
+};
+
+UniquePtr<IHeightMapWriter> makeHeightMapWriter( const HeightMapFormat format, const std::string& path
+                                               , const size_t width, const size_t height, const HeightRange& range );
+
+#include "HeightMapWriter.tpp"
+
+#endif // HMAP_WRITER_H
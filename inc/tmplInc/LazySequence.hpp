@@ -9,8 +9,20 @@
 #include "Cardinal.hpp"
 #include "SharedFromThis.hpp"
 #include "Generator.hpp"
+#include "PrefetchGenerator.hpp"
+#include "CoroutineGenerator.hpp"
+#include "SourceGenerator.hpp"
+#include "TextGenerator.hpp"
+#include "WindowGenerator.hpp"
+#include "CacheManager.hpp"
+#include "SpillFile.hpp"
+#include "Snapshot.hpp"
+#include <fstream>
 #include <functional>
+#include <iterator>
 
+// a sequence is not thread-safe, reading it memoises. a pipeline has to be used by one thread at a time,
+// including the sequences it is built from and the SharedPtr copies of them: the reference counts aren't atomic
 template <typename T>
 class LazySequence : public EnableSharedFromThis<LazySequence<T>>
 {
@@ -25,6 +37,7 @@ public:
                 , const Cardinal& size
                 , const Option<Ordinal>& ordinality
                 , const ArraySequence<T>& data );
+    LazySequence( const std::function<Coroutine<T>()>& body, const Cardinal& size, const Option<Ordinal>& ordinality );
 
     LazySequence( const LazySequence<T>& other );
     LazySequence<T>& operator=( const LazySequence<T>& other );
@@ -45,6 +58,18 @@ public:
                                              , const Cardinal& size
                                              , const Option<Ordinal>& ordinality
                                              , const ArraySequence<T>& data );
+    // the elements are yielded by the body, which is infinite unless told otherwise
+    static SharedPtr<LazySequence<T>> create( const std::function<Coroutine<T>()>& body
+                                            , const Cardinal& size = Cardinal::infiniteCardinal::BETH_0
+                                            , const Option<Ordinal>& ordinality = Ordinal::omega() );
+    // elements of a binary file of T, mapped read-only instead of being loaded
+    static SharedPtr<LazySequence<T>> fromFile( const std::string& path ) requires std::is_trivially_copyable_v<T>;
+    // elements owned by the caller, nothing is copied. release is called once no sequence refers to them
+    static SharedPtr<LazySequence<T>> borrow( const T* data, const size_t size, const std::function<void()>& release = std::function<void()>() );
+    static SharedPtr<LazySequence<T>> fromSource( SharedPtr<ContiguousSource<T>> source );
+    // numbers of a text file read block by block. the size becomes known once the end of the file is reached
+    static SharedPtr<LazySequence<T>> fromText( const std::string& path, const size_t blockSize = TextReader::DEFAULT_BLOCK_SIZE )
+        requires std::is_arithmetic_v<T>;
 public:
     T getFirst();
     T getLast();
@@ -68,18 +93,64 @@ public:
     template <typename T2>
     SharedPtr<LazySequence<T2>> map( const std::function<T2(T)>& func );
 
-    SharedPtr<LazySequence<T>> where( const std::function<bool(T)>& func );
+    SharedPtr<LazySequence<T>> where( const std::function<bool(T)>& func, const ScanBudget& budget = ScanBudget() );
 
     template <typename T2>
     T2 foldl( const std::function<T2(T2, T)>& func, const T2& base );
     template <typename T2>
     T2 foldr( const std::function<T2(T, T2)>& func, const T2& base );
+public:
+    // the k-th element covers elements k to k + width - 1, so width - 1 fewer elements than the sequence has.
+    // the aggregates take O(1) per element whatever the width, window() copies width elements per element
+    SharedPtr<LazySequence<ArraySequence<T>>> window( const size_t width );
+    SharedPtr<LazySequence<WideSum<T>>> rollingSum( const size_t width ) requires std::is_arithmetic_v<T>; // 64 bits wide
+    SharedPtr<LazySequence<double>> rollingMean( const size_t width ) requires std::is_arithmetic_v<T>;
+    SharedPtr<LazySequence<T>> rollingMin( const size_t width );
+    SharedPtr<LazySequence<T>> rollingMax( const size_t width );
+private:
+    template <typename Aggregate>
+    SharedPtr<LazySequence<typename Aggregate::Result>> slide( const size_t width );
+public:
+    // from now on the generator runs up to depth elements ahead on a worker thread. the parents up the pipeline
+    // are read and cached on that thread, so each of them must be read by a single sequence (SHARED_PARENT otherwise)
+    // and must not be read directly by the caller while prefetching
+    void enablePrefetch( const size_t depth = PrefetchGenerator<T>::DEFAULT_DEPTH );
+    bool isPrefetching();
+public:
+    // from now on elements dropped from the cache are written to a memory-mapped file in directory
+    // ($TMPDIR or /tmp by default), and reads behind the cache are served from it instead of the generator
+    void enableSpill( const std::string& directory = std::string() ) requires std::is_trivially_copyable_v<T>;
+    bool isSpilling() const;
 public:
     Cardinal getSize() const;
     size_t getMaterializedCount() const;
     ArraySequence<T> getMaterialized() const;
+    ArraySequence<T> getMaterializedTail( const size_t count ) const; // the newest count cached elements, the rest isn't copied
     bool isEmpty() const;
     bool isFinite() const;
+public:
+    // cached elements, the offset, the ordinality and the state of every generator of the pipeline.
+    // functions can't be saved, so a snapshot is restored into a sequence built the same way
+    void save( std::ostream& out ) const;
+    void save( const std::string& path ) const;
+    void restore( std::istream& in ); // a failed restore leaves the pipeline partially restored
+    void restore( const std::string& path );
+
+    void saveState( SnapshotWriter& out ) const; // same without the header, generators save their parents with it
+    void restoreState( SnapshotReader& in );
+public:
+    // the generator graph the sequence is built from, one node per sequence
+    std::string explain( const ExplainFormat format = ExplainFormat::DOT ) const;
+private:
+    friend class PipelineVisitor;
+    PipelineNode describe() const;
+#ifdef LAZY_SEQUENCE_COUNTERS
+public:
+    CounterSnapshot getCounters( const CounterScope scope = CounterScope::PIPELINE ) const;
+    void resetCounters(); // of this sequence and its generator only
+private:
+    SequenceCounters _counters;
+#endif
 private:
     Cardinal _size;
     size_t _offset;
@@ -89,13 +160,50 @@ private:
     UniquePtr<ArraySequence<T>> _items;
     static const size_t CACHE_MAX_SIZE = 2'000;
     static const size_t CACHE_DECREASE_SIZE = 1'000;
-    static const size_t CACHE_OFFSET_INCREASE = 1'000;
-    void trimCache();
+    void trimCache(); // also reports the size of the cache to the CacheManager
+    void dropOldest( const size_t count );
+    void resolveOrdinality(); // takes the ordinality from the generator once it knows it
+
+    SharedPtr<SpillFile<T>> _spill; // null unless spilling, never shared between sequences
+    Option<T> readSpilled( const Ordinal& index ); // empty unless the element is in the spill file
+private: // positions of the generators reading the sequence, see ParentCursor
+    template <typename U>
+    friend class ParentCursor;
+    size_t attachConsumer( const size_t position );
+    void detachConsumer( const size_t consumer );
+    T readNext( const size_t consumer );
+    T readLagged( const size_t consumer ); // behind the cache, throws CONSUMER_LAGGED unless it can be read anyway
+    bool canReadNext( const size_t consumer );
+    ScanStatus scanNext( const Option<ScanBudget>& budget ); // resolves the ordinality once the generator is finished
+    size_t getSlowestConsumer() const; // SIZE_MAX without consumers
+    size_t getDroppableCount() const; // oldest cached elements no consumer is owed any more, see trimCache()
+
+    DynamicArray<size_t> _consumers; // FREE_CONSUMER where a consumer is gone, the slot is reused
+    static const size_t FREE_CONSUMER = SIZE_MAX;
+    static const size_t CACHE_LAG_MAX_SIZE = 8'000; // unread elements kept for the slowest consumer, see trimCache()
+private:
+    // the cache as the CacheManager sees it, evictions go through it
+    class SequenceCache : public CacheEntry
+    {
+    public:
+        SequenceCache( LazySequence<T>* owner ) : CacheEntry(), _owner( owner ) {}
+    public:
+        size_t evictOldest( const size_t bytes ) override;
+        const void* getOwner() const override { return _owner; }
+        CacheFootprint getFootprint() const override;
+    private:
+        LazySequence<T>* _owner;
+    };
+    SequenceCache _cache { this }; // declared after the items, so it leaves the manager before they are destroyed
+    static const size_t EVICTION_BLOCK = 256;
 public: // methods independent of indices which support correct memoization process
     const T& memoiseNext();
     T get( const Ordinal& index ); // also supports correct memoization because doesn't memoise anything
-    bool canMemoiseNext();
-    Option<T> tryMemoiseNext();
+    bool canMemoiseNext(); // false as well while a where up the pipeline is out of its scan budget
+    Option<T> tryMemoiseNext(); // empty in the same cases
+    // memoises the next element if it is FOUND without where generators up the pipeline spending more than budget.
+    // BUDGET_EXHAUSTED means the scan stopped early and the next call resumes it
+    ScanStatus tryMemoiseNext( const ScanBudget& budget );
 private:
     class LazySequenceIterator
     {
@@ -130,9 +238,76 @@ private:
 public: 
     LazySequenceIterator begin();
     LazySequenceIterator end();
+private:
+    // copies up to count elements starting with from into block, memoising the ones ahead of the cache.
+    // fewer are copied only at the end of the sequence or when a where up the pipeline runs out of its scan budget,
+    // status tells which. slots of block are reused, so it isn't cleared
+    size_t readBlock( const size_t from, const size_t count, ArraySequence<T>& block, ScanStatus& status );
+
+    // walks a block of elements copied out of the sequence by pointer and refills it batch elements at a time,
+    // so a step costs no more than a step over an array. it is at the end once the sequence ends, which
+    // for infinite ones is never, or once a where up the pipeline runs out of its scan budget: getStatus() tells
+    // which, and a stream starting with getIndex() resumes the scan. an exception thrown by a refill leaves it at the end as well
+    class LazySequenceCursor
+    {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type  = std::ptrdiff_t;
+        using value_type = T;
+    public:
+        LazySequenceCursor();
+
+        LazySequenceCursor( SharedPtr<LazySequence<T>> observed, const size_t from, const size_t batch );
+
+        LazySequenceCursor( const LazySequenceCursor& other ) = delete;
+        LazySequenceCursor& operator=( const LazySequenceCursor& other ) = delete;
+
+        LazySequenceCursor( LazySequenceCursor&& other );
+        LazySequenceCursor& operator=( LazySequenceCursor&& other );
+    public:
+        LazySequenceCursor& operator++();
+        void operator++(int);
+
+        const T& operator*() const { return *_current; }
+
+        bool operator==( std::default_sentinel_t ) const noexcept { return _current == _end; }
+        size_t getIndex() const; // of the current element, or of the one a failed refill started with
+        ScanStatus getStatus() const { return _status; } // of the last refill
+    private:
+        void refill();
+    private:
+        SharedPtr<LazySequence<T>> _observed;
+        ArraySequence<T> _block;
+        const T* _current;
+        const T* _end;
+        size_t _base; // index of the first element of the block
+        size_t _batch;
+        ScanStatus _status;
+    };
+
+    class LazySequenceStream
+    {
+    public:
+        LazySequenceStream( SharedPtr<LazySequence<T>> observed, const size_t from, const size_t batch )
+        : _observed( observed ), _from( from ), _batch( batch ) {}
+    public:
+        LazySequenceCursor begin() { return LazySequenceCursor( _observed, _from, _batch ); }
+        std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+    private:
+        SharedPtr<LazySequence<T>> _observed;
+        size_t _from;
+        size_t _batch;
+    };
+public:
+    // an input range of the elements starting with from, infinite sequences included. the elements are
+    // cached as by memoiseNext(), and the cursor reads copies of them, so the sequence stays usable meanwhile
+    LazySequenceStream stream( const size_t from = 0, const size_t batch = STREAM_BATCH );
+
+    static const size_t STREAM_BATCH = 256;
 };
 
 #include "LazySequence.tpp"
 #include "LazySequenceIterator.tpp"
+#include "LazySequenceCursor.tpp"
 
 #endif // LAZY_SEQUENCE_H
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+// key-value cache bounded by the total amount of bytes its values occupy.
+// every value is accounted with the size given on insertion plus the bookkeeping of its entry,
+// the least recently used entries are evicted once the capacity is exceeded
+template <typename K, typename V, typename Hash = std::hash<K>>
+class LruCache
+{
+public:
+    LruCache( const size_t capacity );
+
+    LruCache( const LruCache<K, V, Hash>& other );
+    LruCache<K, V, Hash>& operator=( const LruCache<K, V, Hash>& other );
+
+    LruCache( LruCache<K, V, Hash>&& other ) = default;
+    LruCache<K, V, Hash>& operator=( LruCache<K, V, Hash>&& other ) = default;
+
+    ~LruCache() = default;
+public:
+    V* find( const K& key ); // nullptr if absent, otherwise the entry becomes the most recent one
+    bool contains( const K& key ) const;
+
+    // the inserted value is never evicted by its own insertion, even if it alone exceeds the capacity
+    V& insert( const K& key, V&& value, const size_t bytes );
+    bool erase( const K& key );
+    void clear();
+public:
+    size_t getCapacity() const { return _capacity; }
+    void setCapacity( const size_t capacity );
+
+    size_t getBytes() const { return _bytes; }
+    size_t getCount() const { return _entries.size(); }
+    size_t getHits() const { return _hits; }
+    size_t getMisses() const { return _misses; }
+    size_t getEvictions() const { return _evictions; }
+
+    // approximate bookkeeping cost of one entry: list node, map node and its bucket
+    static constexpr size_t ENTRY_OVERHEAD = 4 * sizeof(void*) + sizeof(K) + sizeof(V) + sizeof(size_t);
+private:
+    struct Entry
+    {
+        K key;
+        V value;
+        size_t bytes;
+    };
+    using EntryList = std::list<Entry>;
+private:
+    void evict( const size_t keep );
+    void reindex();
+private:
+    size_t _capacity;
+    size_t _bytes;
+    size_t _hits;
+    size_t _misses;
+    size_t _evictions;
+    EntryList _entries; // the most recently used first
+    std::unordered_map<K, typename EntryList::iterator, Hash> _index;
+};
+
+#include "LruCache.tpp"
+
+#endif // LRU_CACHE_H
@@ -3,10 +3,16 @@
 
 #include "DynamicArray.hpp"
 #include "Variant.hpp"
+#include <string>
+
+template <typename V>
+struct SnapshotCodec;
 
 class Ordinal
 {
 private:
+    friend struct SnapshotCodec<Ordinal>;
+
     struct Term {
         unsigned _coefficient;
         unsigned _exponent;
@@ -397,6 +403,35 @@ public:
     bool isTransfinite() const {
         return (_value.isInstanceOfT2() && _value.getT2().getSize() > 1);
     }
+public:
+    // the same notation the ui accepts, e.g. w^2*3+w+5
+    std::string toString() const {
+        if (isFinite()) {
+            return std::to_string( getFinite() );
+        }
+        std::string res;
+        const auto& terms = _value.getT2();
+        for (size_t i = 0; i < terms.getSize(); i++) {
+            if (terms[i]._coefficient == 0) {
+                continue;
+            }
+            if (!res.empty()) {
+                res += "+";
+            }
+            if (terms[i]._exponent == 0) {
+                res += std::to_string( terms[i]._coefficient );
+                continue;
+            }
+            res += "w";
+            if (terms[i]._exponent > 1) {
+                res += "^" + std::to_string( terms[i]._exponent );
+            }
+            if (terms[i]._coefficient > 1) {
+                res += "*" + std::to_string( terms[i]._coefficient );
+            }
+        }
+        return res.empty() ? "0" : res;
+    }
 };
 
 inline Ordinal operator+( const size_t& arg1, const Ordinal& arg2 ) {
@@ -0,0 +1,57 @@
+#ifndef PARENT_CURSOR_H
+#define PARENT_CURSOR_H
+
+#include "SharedPtr.hpp"
+#include "Option.hpp"
+#include "ScanBudget.hpp"
+#include "Snapshot.hpp"
+
+template <typename T>
+class LazySequence;
+
+class PipelineVisitor;
+
+// the position of a generator in the sequence it pulls from. the sequence registers every cursor and keeps its
+// cached elements until the slowest cursor has read them, so generators built from the same sequence read all
+// of its elements independently of each other, and each element is computed by the sequence once.
+// a cursor may fall up to CACHE_LAG_MAX_SIZE elements behind the fastest one, see LazySequence::trimCache().
+// a copy is another cursor at the same position
+template <typename T>
+class ParentCursor
+{
+public:
+    ParentCursor(); // reads nothing
+    ParentCursor( SharedPtr<LazySequence<T>> parent ); // starts with the first element
+
+    ParentCursor( const ParentCursor<T>& other );
+    ParentCursor<T>& operator=( const ParentCursor<T>& other );
+
+    ParentCursor( ParentCursor<T>&& other );
+    ParentCursor<T>& operator=( ParentCursor<T>&& other );
+
+    ~ParentCursor(); // lets the sequence trim what only this cursor was waiting for
+public:
+    T next();
+    bool hasNext();
+    ScanStatus scan( const Option<ScanBudget>& budget ); // for the element next() returns, see IGenerator::scan()
+
+    size_t getPosition() const; // index of the element next() returns
+    const SharedPtr<LazySequence<T>>& getSequence() const { return _parent; }
+
+    LazySequence<T>* operator->() { return _parent.operator->(); }
+    const LazySequence<T>* operator->() const { return _parent.operator->(); }
+    LazySequence<T>& operator*() { return *_parent; }
+public: // the position is saved along with the sequence
+    void saveState( SnapshotWriter& out ) const;
+    void restoreState( SnapshotReader& in );
+private:
+    void attach( const size_t position );
+    void detach();
+private:
+    SharedPtr<LazySequence<T>> _parent;
+    size_t _consumer;
+};
+
+#include "ParentCursor.tpp"
+
+#endif // PARENT_CURSOR_H
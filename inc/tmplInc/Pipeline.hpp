@@ -0,0 +1,108 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <string>
+#include "ArraySequence.hpp"
+#include "Option.hpp"
+#include "Ordinal.hpp"
+#include "SharedPtr.hpp"
+#include "SequenceCounters.hpp"
+
+template <typename T>
+class LazySequence;
+
+// what a sequence of any element type looks like from the outside of a pipeline
+struct PipelineNode
+{
+    const void* id = nullptr;
+    std::string generator;
+    Option<Ordinal> ordinality;
+    size_t cached = 0;        // elements held by the cache
+    size_t materialized = 0;  // elements produced so far, including the trimmed ones
+    size_t cacheBytes = 0;
+    double pullFactor = 1.0;  // parent elements pulled per element of the sequence
+    size_t consumers = 0;     // sequences built from this one which are reading it
+#ifdef LAZY_SEQUENCE_COUNTERS
+    SequenceCounters counters; // of the sequence and its generator
+#endif
+};
+
+// walks the generator graph starting with a sequence. generators report the sequences they pull from,
+// each sequence is reported to onNode() once even if several others are built from it
+class PipelineVisitor
+{
+public:
+    PipelineVisitor( const bool followParents = true ) : _followParents( followParents ), _current( nullptr ), _visited() {}
+    virtual ~PipelineVisitor() = default;
+public:
+    template <typename U>
+    void visit( const LazySequence<U>& seq ); // defined along with LazySequence
+    template <typename U>
+    void visit( const SharedPtr<LazySequence<U>>& seq );
+protected:
+    virtual void onNode( const PipelineNode& node ) = 0;
+    virtual void onEdge( const void* child, const void* parent ) { (void)child; (void)parent; }
+private:
+    bool markVisited( const void* node );
+private:
+    bool _followParents;
+    const void* _current; // the sequence whose parents are being visited
+    ArraySequence<const void*> _visited;
+};
+
+enum class ExplainFormat {
+    DOT = 0,
+    JSON = 1
+};
+
+// the whole graph with an estimated number of generator calls per element of every sequence.
+// a sequence pulls pullFactor elements of its most expensive parent per element, so the estimate
+// is exact for chains and an upper bound for append/concat, which pull from one parent at a time
+class PipelinePlan : public PipelineVisitor
+{
+public:
+    PipelinePlan() : PipelineVisitor( true ), _nodes(), _edgesFrom(), _edgesTo() {}
+public:
+    size_t getNodeCount() const { return _nodes.getSize(); }
+    const PipelineNode& getNode( const size_t index ) const { return _nodes[index]; }
+    ArraySequence<double> getPullCosts() const; // in the order of nodes
+    size_t getDepth() const; // sequences on the longest chain from the visited one to a source, 0 if nothing was visited
+#ifdef LAZY_SEQUENCE_COUNTERS
+    // nanoseconds of every node without the time spent in its parents, in the order of nodes.
+    // a parent read by several sequences is charged to them evenly, so with shared parents it is an estimate
+    ArraySequence<size_t> getSelfNanoseconds() const;
+#endif
+
+    std::string render( const ExplainFormat format ) const;
+protected:
+    void onNode( const PipelineNode& node ) override;
+    void onEdge( const void* child, const void* parent ) override;
+private:
+    size_t indexOf( const void* id ) const;
+    double pullCost( const size_t index, ArraySequence<double>& costs ) const;
+    size_t depth( const size_t index, ArraySequence<size_t>& depths ) const;
+    std::string renderDot() const;
+    std::string renderJson() const;
+private:
+    ArraySequence<PipelineNode> _nodes;
+    ArraySequence<const void*> _edgesFrom;
+    ArraySequence<const void*> _edgesTo;
+};
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+class CounterCollector : public PipelineVisitor
+{
+public:
+    CounterCollector( const CounterScope scope ) : PipelineVisitor( scope == CounterScope::PIPELINE ), _snapshot() {}
+public:
+    const CounterSnapshot& getSnapshot() const { return _snapshot; }
+protected:
+    void onNode( const PipelineNode& node ) override;
+private:
+    CounterSnapshot _snapshot;
+};
+#endif
+
+#include "Pipeline.tpp"
+
+#endif // PIPELINE_H
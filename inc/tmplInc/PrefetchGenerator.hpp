@@ -0,0 +1,65 @@
+#ifndef PREFETCH_GENERATOR_H
+#define PREFETCH_GENERATOR_H
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "Generator.hpp"
+#include "SpscRing.hpp"
+
+// runs the wrapped generator on a worker thread up to depth elements ahead of the consumer.
+// the worker is started by the first request of an element, so wrapping keeps the sequence lazy.
+// an exception thrown by the wrapped generator reaches the consumer right after the elements produced before it.
+// the worker isn't bound by the scan budgets of where generators, it keeps scanning while there is space in the ring.
+// the wrapped generator must not be used by anyone else while prefetching: generators which pull from
+// parent sequences keep doing so on the worker thread
+template <typename T>
+class PrefetchGenerator : public IGenerator<T>
+{
+public:
+    // first is the index get() uses for the next element of the wrapped generator
+    PrefetchGenerator( SharedPtr<IGenerator<T>> source, const size_t depth = DEFAULT_DEPTH, const size_t first = 0 );
+
+    PrefetchGenerator( const PrefetchGenerator<T>& other ) = delete;
+    PrefetchGenerator<T>& operator=( const PrefetchGenerator<T>& other ) = delete;
+
+    PrefetchGenerator( PrefetchGenerator<T>&& other ) = delete;
+    PrefetchGenerator<T>& operator=( PrefetchGenerator<T>&& other ) = delete;
+
+    ~PrefetchGenerator(); // stops the worker, elements produced ahead are dropped
+public:
+    T getNext() override;
+    T get( const Ordinal& index ) override; // elements produced ahead come from the ring, the rest from the wrapped generator
+    bool hasNext() override;
+    Option<T> tryGetNext() override;
+    ScanStatus scan( const Option<ScanBudget>& budget ) override; // the state of the ring, waits for it only without a bound
+    Option<Ordinal> getOrdinality() const override; // the worker may find the end before the consumer does
+public: // the wrapped generator is reported as a part of this one
+    std::string getName() const override;
+    void visitParents( PipelineVisitor& visitor ) const override;
+    double getPullFactor() const override;
+    size_t getStateBytes() const override; // the ring is counted in full
+#ifdef LAZY_SEQUENCE_COUNTERS
+    void addCounters( SequenceCounters& total ) const override;
+#endif
+public:
+    size_t getDepth() const { return _ring.getCapacity(); }
+    size_t getBuffered() const { return _ring.getSize(); }
+
+    static const size_t DEFAULT_DEPTH = 64;
+private:
+    void start();
+    void produce();
+    void rethrow();
+private:
+    SharedPtr<IGenerator<T>> _source; // used under _sourceLock only
+    mutable std::mutex _sourceLock;
+    SpscRing<T> _ring;
+    std::thread _worker;
+    size_t _consumed; // index of the first element in the ring, used by the consumer only
+    std::exception_ptr _error; // set by the worker before closing the ring
+};
+
+#include "PrefetchGenerator.tpp"
+
+#endif // PREFETCH_GENERATOR_H
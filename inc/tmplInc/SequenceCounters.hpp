@@ -0,0 +1,68 @@
+#ifndef SEQUENCE_COUNTERS_H
+#define SEQUENCE_COUNTERS_H
+
+// performance counters of sequences and their generators. they are only compiled in with
+// LAZY_SEQUENCE_COUNTERS defined, otherwise none of the members exist and LAZY_COUNT, LAZY_TIME expand to nothing
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+
+#include <chrono>
+#include <cstddef>
+
+struct SequenceCounters
+{
+    size_t generatorCalls = 0;         // getNext()/get() requests made by a sequence to its generator
+    size_t cacheHits = 0;              // operator[] served from the cache
+    size_t cacheMisses = 0;            // operator[] which had to ask the generator
+    size_t trims = 0;
+    size_t bytesTrimmed = 0;
+    size_t dematerializedAccesses = 0; // DEMATERIALIZED_ACCESS thrown
+    size_t replays = 0;                // get() recomputing elements ahead of the generator's own position
+    size_t whereRejections = 0;
+    size_t spillReads = 0;             // elements behind the cache read back from the spill file
+    size_t nanoseconds = 0;            // spent serving elements, including the time spent in parent sequences
+
+    SequenceCounters& operator+=( const SequenceCounters& other );
+};
+
+enum class CounterScope {
+    SEQUENCE = 0, // the sequence and its generator
+    PIPELINE = 1  // every sequence the sequence is built from, each of them counted once
+};
+
+struct CounterSnapshot
+{
+    SequenceCounters counters;
+    size_t sequences = 0;
+};
+
+// adds the time until the end of the enclosing scope to target
+class CounterTimer
+{
+public:
+    CounterTimer( size_t& target ) : _target( target ), _start( std::chrono::steady_clock::now() ) {}
+    ~CounterTimer() {
+        _target += static_cast<size_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                            std::chrono::steady_clock::now() - _start ).count() );
+    }
+
+    CounterTimer( const CounterTimer& other ) = delete;
+    CounterTimer& operator=( const CounterTimer& other ) = delete;
+private:
+    size_t& _target;
+    std::chrono::steady_clock::time_point _start;
+};
+
+#define LAZY_COUNT( field, amount ) (this->_counters.field += (amount))
+#define LAZY_TIME( field ) CounterTimer lazyCounterTimer( this->_counters.field )
+
+#include "SequenceCounters.tpp"
+
+#else
+
+#define LAZY_COUNT( field, amount ) ((void)0)
+#define LAZY_TIME( field ) ((void)0)
+
+#endif // LAZY_SEQUENCE_COUNTERS
+
+#endif // SEQUENCE_COUNTERS_H
@@ -0,0 +1,91 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include "ArraySequence.hpp"
+#include "Option.hpp"
+#include "Ordinal.hpp"
+
+// binary snapshots of sequences, see LazySequence::save(). values are stored in the native byte order,
+// so a snapshot is only meant to be restored on the kind of machine it was made on
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// how values of type V are stored. trivially copyable types are stored as they are, the specializations
+// below cover strings, ordinals, options and array sequences, other element types can add their own
+template <typename V>
+struct SnapshotCodec
+{
+    static void write( SnapshotWriter& out, const V& value ); // throws UNSUPPORTED_SNAPSHOT
+    static V read( SnapshotReader& in );
+};
+
+class SnapshotWriter
+{
+public:
+    explicit SnapshotWriter( std::ostream& out ) : _out( out ) {}
+public:
+    void writeHeader();
+    void writeBytes( const void* data, const size_t count );
+
+    template <typename V>
+    void write( const V& value );
+private:
+    std::ostream& _out;
+};
+
+class SnapshotReader
+{
+public:
+    explicit SnapshotReader( std::istream& in );
+public:
+    void readHeader(); // throws SNAPSHOT_MISMATCH for foreign data and other versions
+    void readBytes( void* data, const size_t count );
+    // throws SNAPSHOT_MISMATCH unless count items of itemBytes each are left, so a corrupt length doesn't get allocated.
+    // streams that can't seek aren't checked, readBytes() still catches them running short
+    void expectRemaining( const size_t count, const size_t itemBytes );
+
+    template <typename V>
+    V read();
+    template <typename V>
+    void expect( const V& value ); // throws SNAPSHOT_MISMATCH unless the next value equals value
+private:
+    std::istream& _in;
+    std::streamoff _end; // -1 unless the stream can seek
+};
+
+template <>
+struct SnapshotCodec<std::string>
+{
+    static void write( SnapshotWriter& out, const std::string& value );
+    static std::string read( SnapshotReader& in );
+};
+
+template <>
+struct SnapshotCodec<Ordinal>
+{
+    static void write( SnapshotWriter& out, const Ordinal& value );
+    static Ordinal read( SnapshotReader& in );
+};
+
+template <typename V>
+struct SnapshotCodec<Option<V>>
+{
+    static void write( SnapshotWriter& out, const Option<V>& value );
+    static Option<V> read( SnapshotReader& in );
+};
+
+template <typename V>
+struct SnapshotCodec<ArraySequence<V>>
+{
+    static void write( SnapshotWriter& out, const ArraySequence<V>& value );
+    static ArraySequence<V> read( SnapshotReader& in );
+};
+
+#include "Snapshot.tpp"
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,93 @@
+#ifndef SOURCE_GENERATOR_H
+#define SOURCE_GENERATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include "Generator.hpp"
+
+// read-only elements laid out contiguously somewhere else. sequences refer to them instead of copying,
+// the source stays alive as long as any generator does
+template <typename T>
+class ContiguousSource
+{
+public:
+    virtual ~ContiguousSource() = default;
+
+    virtual const T* getData() const = 0;
+    virtual size_t getSize() const = 0;
+};
+
+// binary file of T mapped read-only. pages are read in on first access and dropped by the kernel under pressure
+template <typename T>
+class MappedFile : public ContiguousSource<T>
+{
+public:
+    MappedFile( const std::string& path ); // INVALID_SIZE unless the file holds a whole number of elements
+
+    MappedFile( const MappedFile<T>& other ) = delete;
+    MappedFile<T>& operator=( const MappedFile<T>& other ) = delete;
+
+    ~MappedFile();
+public:
+    const T* getData() const override { return static_cast<const T*>( _map ); }
+    size_t getSize() const override { return _bytes / sizeof(T); }
+private:
+    void* _map;
+    size_t _bytes;
+};
+
+// elements owned by the caller. release is the ownership guard: it is called once no generator refers to them
+template <typename T>
+class BorrowedBuffer : public ContiguousSource<T>
+{
+public:
+    BorrowedBuffer( const T* data, const size_t size, const std::function<void()>& release = std::function<void()>() )
+    : _data( data ), _size( size ), _release( release ) {}
+
+    BorrowedBuffer( const BorrowedBuffer<T>& other ) = delete;
+    BorrowedBuffer<T>& operator=( const BorrowedBuffer<T>& other ) = delete;
+
+    ~BorrowedBuffer() {
+        if (_release) { _release(); }
+    }
+public:
+    const T* getData() const override { return _data; }
+    size_t getSize() const override { return _size; }
+private:
+    const T* _data;
+    size_t _size;
+    std::function<void()> _release;
+};
+
+// finite generator over a contiguous source, every element is reachable in constant time
+template <typename T>
+class SourceGenerator : public IGenerator<T>
+{
+public:
+    SourceGenerator( SharedPtr<ContiguousSource<T>> source );
+
+    SourceGenerator( const SourceGenerator<T>& other ) = default;
+    SourceGenerator<T>& operator=( const SourceGenerator<T>& other ) = default;
+
+    ~SourceGenerator() = default;
+public:
+    T getNext() override;
+    T get( const Ordinal& index ) override;
+    bool hasNext() override;
+    Option<T> tryGetNext() override;
+    bool isRandomAccess() const override { return true; }
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override;
+public:
+    size_t getSize() const { return _size; }
+private:
+    SharedPtr<ContiguousSource<T>> _source;
+    const T* _data;
+    size_t _size;
+    size_t _lastMaterialized;
+};
+
+#include "SourceGenerator.tpp"
+
+#endif // SOURCE_GENERATOR_H
@@ -0,0 +1,42 @@
+#ifndef SPILL_FILE_H
+#define SPILL_FILE_H
+
+#include <cstddef>
+#include <string>
+#include "util.hpp"
+
+// append-only file of consecutive elements, the ones at indices [base, base + count), read back through a memory map.
+// the file is unlinked right after creation, so it disappears with the process. T must be trivially copyable,
+// the members are only instantiated for such T
+template <typename T>
+class SpillFile
+{
+public:
+    SpillFile( const size_t base, const std::string& directory = std::string() ); // $TMPDIR or /tmp by default
+
+    SpillFile( const SpillFile<T>& other ) = delete;
+    SpillFile<T>& operator=( const SpillFile<T>& other ) = delete;
+
+    ~SpillFile();
+public:
+    void append( const T* values, const size_t count );
+    T read( const size_t index ); // maps the part written since the last read if needed
+    void clear( const size_t base ); // drops every element, the next one appended is the one at base
+
+    bool contains( const size_t index ) const { return _base <= index && index < _base + _count; }
+    size_t getBase() const { return _base; }
+    size_t getCount() const { return _count; }
+    size_t getBytes() const { return _count * sizeof(T); }
+private:
+    void remap();
+private:
+    int _fd;
+    size_t _base;
+    size_t _count;
+    void* _map;
+    size_t _mapped; // bytes
+};
+
+#include "SpillFile.tpp"
+
+#endif // SPILL_FILE_H
@@ -0,0 +1,57 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "util.hpp"
+
+// bounded single-producer single-consumer queue. transfers never take a lock: each side owns one index
+// and publishes it with a single atomic store. a side only blocks (on the other side's wake-up counter)
+// when the ring is full or empty, and the other side notifies it only if it is actually waiting
+template <typename T>
+class SpscRing
+{
+public:
+    SpscRing( const size_t capacity ); // rounded up to a power of two
+
+    SpscRing( const SpscRing<T>& other ) = delete;
+    SpscRing<T>& operator=( const SpscRing<T>& other ) = delete;
+
+    ~SpscRing();
+public: // producer side
+    bool push( T&& value ); // blocks while full, false once cancelled
+    bool waitForSpace(); // same as push, but pushes nothing
+    void close(); // no more values will be pushed
+public: // consumer side
+    bool pop( T& value ); // blocks while empty, false once closed and drained
+    bool waitForValue(); // same as pop, but leaves the value in the ring
+    bool peek( const size_t offset, T& value ) const; // copies the value offset places after the next one, never blocks
+    void cancel(); // makes the producer give up on pushing
+public:
+    size_t getCapacity() const { return _mask + 1; }
+    size_t getSize() const;
+    bool isClosed() const { return _closed.load( std::memory_order_acquire ); }
+    bool isCancelled() const { return _cancelled.load( std::memory_order_acquire ); }
+private:
+    static void wake( std::atomic<bool>& waiting, std::atomic<uint32_t>& epoch );
+private:
+    static const size_t CACHE_LINE = 64;
+
+    T* _slots;
+    size_t _mask;
+
+    alignas(CACHE_LINE) std::atomic<size_t> _head; // next slot to be read, written by the consumer only
+    alignas(CACHE_LINE) std::atomic<size_t> _tail; // next slot to be written, written by the producer only
+
+    alignas(CACHE_LINE) std::atomic<bool> _closed;
+    std::atomic<bool> _cancelled;
+    std::atomic<bool> _producerWaiting;
+    std::atomic<bool> _consumerWaiting;
+    std::atomic<uint32_t> _producerEpoch;
+    std::atomic<uint32_t> _consumerEpoch;
+};
+
+#include "SpscRing.tpp"
+
+#endif // SPSC_RING_H
@@ -0,0 +1,45 @@
+#ifndef TEXT_GENERATOR_H
+#define TEXT_GENERATOR_H
+
+#include <string>
+#include <type_traits>
+#include "Generator.hpp"
+#include "TextReader.hpp"
+
+// numbers of a text file, e.g. a csv written by HeightMapWriter, parsed with from_chars while the file is read.
+// only one block of the file is held at a time. the count of numbers is known once the end of the file is reached
+template <typename T> requires std::is_arithmetic_v<T>
+class TextGenerator : public IGenerator<T>
+{
+public:
+    TextGenerator( const std::string& path, const size_t blockSize = TextReader::DEFAULT_BLOCK_SIZE );
+
+    TextGenerator( const TextGenerator<T>& other ) = delete;
+    TextGenerator<T>& operator=( const TextGenerator<T>& other ) = delete;
+
+    ~TextGenerator() = default;
+public:
+    T getNext() override;
+    T get( const Ordinal& index ) override; // reads the file again from the beginning up to the index
+    bool hasNext() override;
+    Option<T> tryGetNext() override;
+    Option<Ordinal> getOrdinality() const override;
+    size_t getStateBytes() const override; // the block
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override; // skips the numbers read before
+private:
+    static T parse( const std::string_view& token );
+private:
+    std::string _path;
+    TextReader _reader;
+    size_t _lastMaterialized;
+    T _pending; // parsed by hasNext(), returned by the next getNext()
+    bool _hasPending;
+    std::string _unparsed; // a token which failed to parse. it stays the next one, so it is never skipped silently
+    bool _hasUnparsed;
+    bool _isExhausted;
+};
+
+#include "TextGenerator.tpp"
+
+#endif // TEXT_GENERATOR_H
@@ -0,0 +1,122 @@
+#ifndef TILE_H
+#define TILE_H
+
+#include <cstddef>
+#include <new>
+#include "util.hpp"
+#include "ArraySequence.hpp"
+
+static const size_t TILE_ALIGNMENT = 64; // one cache line, also enough for any avx load
+
+// cells of a square tile. fixed-size tiles keep them inline, dynamic ones (N == 0) own an aligned heap block
+template <size_t N>
+class TileStorage
+{
+public:
+    TileStorage() : _cells() {}
+    TileStorage( const size_t size ) : _cells() {
+        if (size != N) {
+            throw Exception( Exception::ErrorCode::INVALID_SIZE );
+        }
+    }
+
+    TileStorage( const TileStorage<N>& other ) = default;
+    TileStorage<N>& operator=( const TileStorage<N>& other ) = default;
+
+    ~TileStorage() = default;
+public:
+    size_t getSize() const { return N; }
+    float* getCells() { return _cells; }
+    const float* getCells() const { return _cells; }
+private:
+    alignas(TILE_ALIGNMENT) float _cells[N * N];
+};
+
+template <>
+class TileStorage<0>
+{
+public:
+    TileStorage() : _cells( nullptr ), _size(0) {}
+    TileStorage( const size_t size ) : _cells( allocate( size ) ), _size( size ) {}
+
+    TileStorage( const TileStorage<0>& other );
+    TileStorage<0>& operator=( const TileStorage<0>& other );
+
+    TileStorage( TileStorage<0>&& other );
+    TileStorage<0>& operator=( TileStorage<0>&& other );
+
+    ~TileStorage();
+public:
+    size_t getSize() const { return _size; }
+    float* getCells() { return _cells; }
+    const float* getCells() const { return _cells; }
+private:
+    static float* allocate( const size_t size );
+    static void release( float* cells );
+private:
+    float* _cells;
+    size_t _size;
+};
+
+// read-only view of a tile column, keeps the old chunk[col][row] access working
+class TileColumn
+{
+public:
+    TileColumn( const float* cells, const size_t col, const size_t size ) : _cells( cells ), _col( col ), _size( size ) {}
+public:
+    const float& operator[]( const size_t row ) const;
+    size_t getSize() const { return _size; }
+
+    operator ArraySequence<float>() const; // copies the column out, as assigning chunk columns used to
+private:
+    const float* _cells;
+    size_t _col;
+    size_t _size;
+};
+
+// flat square matrix of floats, stored row-major in a single aligned block.
+// N fixes the side at compile time, N == 0 sizes the tile at runtime
+template <size_t N = 0>
+class Tile
+{
+public:
+    Tile() : _storage() {}
+    Tile( const size_t size ) : _storage( size ) {}
+    Tile( const size_t size, const float value );
+
+    Tile( const Tile<N>& other ) = default;
+    Tile<N>& operator=( const Tile<N>& other ) = default;
+
+    Tile( Tile<N>&& other ) = default;
+    Tile<N>& operator=( Tile<N>&& other ) = default;
+
+    template <size_t M>
+    Tile( const Tile<M>& other ); // resizing between fixed and dynamic sides, the sides must match
+
+    ~Tile() = default;
+public:
+    float& operator()( const size_t row, const size_t col );
+    const float& operator()( const size_t row, const size_t col ) const;
+
+    TileColumn operator[]( const size_t col ) const;
+
+    // unchecked pointers to the beginning of the row, for the hot loops
+    float* row( const size_t row ) { return _storage.getCells() + row * getSize(); }
+    const float* row( const size_t row ) const { return _storage.getCells() + row * getSize(); }
+public:
+    size_t getSize() const { return _storage.getSize(); }
+    size_t getCount() const { return getSize() * getSize(); }
+    size_t getBytes() const { return getCount() * sizeof(float); }
+
+    float* getData() { return _storage.getCells(); }
+    const float* getData() const { return _storage.getCells(); }
+
+    ArraySequence<float> getRow( const size_t row ) const;
+    ArraySequence<float> getColumn( const size_t col ) const;
+private:
+    TileStorage<N> _storage;
+};
+
+#include "Tile.tpp"
+
+#endif // TILE_H
@@ -0,0 +1,153 @@
+#ifndef WINDOW_GENERATOR_H
+#define WINDOW_GENERATOR_H
+
+#include <functional>
+#include <type_traits>
+#include "Generator.hpp"
+
+// a fixed capacity ring, used both for the elements of a window and for the monotonic deques of the extremums
+template <typename T>
+class WindowRing
+{
+public:
+    WindowRing( const size_t capacity );
+public:
+    void pushBack( const T& value ); // the ring must not be full
+    T popFront();
+    void popBack();
+
+    const T& front() const;
+    const T& back() const;
+    const T& operator[]( const size_t index ) const; // counted from the front
+
+    size_t getSize() const { return _size; }
+    size_t getCapacity() const { return _slots.getSize(); }
+    bool isEmpty() const { return _size == 0; }
+    bool isFull() const { return _size == _slots.getSize(); }
+
+    ArraySequence<T> toSequence() const; // from the front to the back
+private:
+    ArraySequence<T> _slots;
+    size_t _head;
+    size_t _size;
+};
+
+// aggregates of a window see it gain its first elements one by one with add(), then slide() by an element per step.
+// get() is called only on full windows
+
+// the elements themselves, copied out on every step
+template <typename T>
+class WindowElements
+{
+public:
+    using Result = ArraySequence<T>;
+
+    WindowElements( const size_t width ) { (void)width; }
+
+    void add( const T& value ) { (void)value; }
+    void slide( const T& removed, const T& added, const WindowRing<T>& window );
+    Result get( const WindowRing<T>& window ) const { return window.toSequence(); }
+    size_t getStateBytes() const { return 0; }
+};
+
+// the type sums of T are reported in, so a window of ints near the limit doesn't overflow
+template <typename T>
+using WideSum = std::conditional_t<std::is_floating_point_v<T>, double
+              , std::conditional_t<std::is_signed_v<T>, long long, unsigned long long>>;
+
+// integers are summed exactly in 64 bits. floating point sums are recomputed once per width steps,
+// which bounds the error gathered by adding and subtracting and keeps a step O(1) amortized
+template <typename T> requires std::is_arithmetic_v<T>
+class RollingSum
+{
+public:
+    using Result = WideSum<T>;
+    using Accumulator = WideSum<T>;
+
+    RollingSum( const size_t width ) : _sum( 0 ), _slides( 0 ) { (void)width; }
+
+    void add( const T& value ) { _sum += value; }
+    void slide( const T& removed, const T& added, const WindowRing<T>& window );
+    Result get( const WindowRing<T>& window ) const { (void)window; return _sum; }
+    size_t getStateBytes() const { return 0; }
+protected:
+    Accumulator _sum;
+    size_t _slides; // since the sum was last recomputed
+};
+
+template <typename T> requires std::is_arithmetic_v<T>
+class RollingMean : public RollingSum<T>
+{
+public:
+    using Result = double;
+
+    RollingMean( const size_t width ) : RollingSum<T>( width ) {}
+
+    Result get( const WindowRing<T>& window ) const {
+        return static_cast<double>( this->_sum ) / static_cast<double>( window.getSize() );
+    }
+};
+
+// the deque holds the candidates for the extremum of the window in the order they came, each of them preferred
+// by compare to everyone after it, so the front is the extremum. a new element pushes out the candidates it beats,
+// equal ones stay, so the element leaving the window is the front exactly when it equals the front
+template <typename T, typename Compare>
+class RollingExtremum
+{
+public:
+    using Result = T;
+
+    RollingExtremum( const size_t width ) : _candidates( width ), _compare() {}
+
+    void add( const T& value );
+    void slide( const T& removed, const T& added, const WindowRing<T>& window );
+    Result get( const WindowRing<T>& window ) const { (void)window; return _candidates.front(); }
+    size_t getStateBytes() const { return _candidates.getSize() * sizeof(T); }
+private:
+    WindowRing<T> _candidates;
+    Compare _compare;
+};
+
+template <typename T>
+using RollingMin = RollingExtremum<T, std::less<T>>;
+
+template <typename T>
+using RollingMax = RollingExtremum<T, std::greater<T>>;
+
+// the k-th element aggregates elements k to k + width - 1 of the parent, so a parent shorter than width gives none.
+// the window is filled before the first element, then every element slides it by one parent element
+template <typename T, typename Aggregate>
+class WindowGenerator : public IGenerator<typename Aggregate::Result>
+{
+public:
+    using Result = typename Aggregate::Result;
+
+    WindowGenerator( SharedPtr<LazySequence<T>> parent, const size_t width );
+
+    WindowGenerator( const WindowGenerator<T, Aggregate>& other ) = default;
+    WindowGenerator<T, Aggregate>& operator=( const WindowGenerator<T, Aggregate>& other ) = default;
+
+    ~WindowGenerator() = default;
+public:
+    Result getNext() override;
+    Result get( const Ordinal& index ) override; // aggregates the window from scratch, finite indices only
+    bool hasNext() override;
+    Option<Result> tryGetNext() override;
+    void visitParents( PipelineVisitor& visitor ) const override;
+    size_t getStateBytes() const override; // the window and the deque of the extremums
+    void saveState( SnapshotWriter& out ) const override;
+    void restoreState( SnapshotReader& in ) override; // the aggregate is rebuilt from the saved window
+public:
+    size_t getWidth() const { return _window.getCapacity(); }
+private:
+    void push( const T& value ); // while the window is being filled
+private:
+    ParentCursor<T> _parent;
+    WindowRing<T> _window;
+    Aggregate _aggregate;
+    size_t _emitted;
+};
+
+#include "WindowGenerator.tpp"
+
+#endif // WINDOW_GENERATOR_H
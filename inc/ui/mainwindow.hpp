@@ -4,13 +4,14 @@
 #include <regex>
 #include <algorithm>
 #include <QMainWindow>
-#include <QListWidgetItem>
-#include <QMetaType>
+#include <QList>
 #include "LazySequence.hpp"
+#include "sequencemodel.hpp"
+#include "materializetask.hpp"
+#include "perfpanel.hpp"
 
 
 #include <iostream>
-Q_DECLARE_METATYPE(SharedPtr<LazySequence<int>>)
 
 QT_BEGIN_NAMESPACE
 namespace Ui 
@@ -37,8 +38,21 @@ private slots:
     void on_subSeqBtn_clicked();
     void on_mapBtn_clicked();
     void on_whereBtn_clicked();
+    void on_materializeBtn_clicked();
+    void on_cancelBtn_clicked();
+
+    void onMaterializeProgress( qulonglong done, qulonglong total );
+    void onMaterializeFinished( qulonglong done, bool isCancelled );
+    void onMaterializeFailed( QString message );
+    void onCurrentSequenceChanged();
 private:
     Ui::MainWindow *ui;
+    SequenceModel *seqModel;
+    MaterializeTask *materializeTask = nullptr;
+    PerfPanel *perfPanel;
+
+    void setBusy( const bool isBusy ); // locks every action which could touch sequences while a task runs
+    void endMaterialize();
 
     template <typename T>
     T getFromInput( const QString& input ) const;
@@ -72,25 +86,14 @@ private:
                                              };
     }
 
-    static QString contentsStr( const SharedPtr<LazySequence<int>>& item ) { 
-        QString res = "{";
-        auto buff = item->getMaterialized();
-
-        int limit = 15;
-        int size = buff.getSize();
-
-        for (int i = std::max(0, size - limit); i < size; i++) {
-            if (i != 0) { res += ", "; }
-            res += QString::fromStdString( std::format( "{}", buff[i] ));
-        }
-        res += "}"; 
-        
-        return res;
+    // keeps a single pull on a sparse filter from freezing the window, the next pull resumes the scan
+    static ScanBudget interactiveBudget() {
+        return ScanBudget( 10'000, std::chrono::milliseconds(50) );
     }
 
     void addToList( const SharedPtr<LazySequence<int>>& seq );
-
-    void addToList( SharedPtr<LazySequence<int>>& item );
+    SharedPtr<LazySequence<int>> currentSequence() const; // INVALID_SELECTION without one
+    QList<SharedPtr<LazySequence<int>>> selectedSequences() const;
     void updateUI();
     void showError( const std::exception &ex );
     
@@ -0,0 +1,38 @@
+#ifndef MATERIALIZETASK_H
+#define MATERIALIZETASK_H
+
+#include <atomic>
+#include <QFuture>
+#include <QObject>
+#include <QString>
+#include "LazySequence.hpp"
+
+// memoises up to count elements of a sequence on the global thread pool. the signals are queued to the thread
+// the task lives on, progress at most every PROGRESS_INTERVAL_MS. while it runs, nothing else may touch the
+// sequence or anything in its pipeline, SharedPtr copies included: the reference counts aren't atomic
+class MaterializeTask : public QObject
+{
+    Q_OBJECT
+public:
+    MaterializeTask( const SharedPtr<LazySequence<int>>& seq, const size_t count, QObject* parent = nullptr );
+    ~MaterializeTask(); // cancels the worker and waits for it
+public:
+    void start();
+    void cancel(); // the worker stops once the element it is computing is done
+    bool isRunning() const;
+signals:
+    void progress( qulonglong done, qulonglong total );
+    void finished( qulonglong done, bool isCancelled ); // also when a finite sequence ends before count
+    void failed( QString message );
+private:
+    void run();
+private:
+    SharedPtr<LazySequence<int>> _seq;
+    size_t _count;
+    std::atomic<bool> _isCancelled;
+    QFuture<void> _future;
+
+    static const int PROGRESS_INTERVAL_MS = 50;
+};
+
+#endif // MATERIALIZETASK_H
@@ -0,0 +1,48 @@
+#ifndef PERFPANEL_H
+#define PERFPANEL_H
+
+#include <QDockWidget>
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QTableWidget>
+#include <QTimer>
+#include "LazySequence.hpp"
+
+// live figures of one sequence and of every stage of its pipeline, sampled every REFRESH_INTERVAL_MS on the UI thread.
+// trims and the time per stage come from the counters, so they are only shown in builds with LAZY_SEQUENCE_COUNTERS.
+// while frozen the pipeline isn't read at all and the rate is taken from the reported progress instead
+class PerfPanel : public QDockWidget
+{
+    Q_OBJECT
+public:
+    explicit PerfPanel( QWidget* parent = nullptr );
+public:
+    void setSequence( const SharedPtr<LazySequence<int>>& seq ); // a null one clears the panel
+    void setFrozen( const bool isFrozen );
+    bool isFrozen() const;
+    void reportProgress( const size_t done ); // elements materialized by the running task so far
+private slots:
+    void sample();
+private:
+    void showStages( const PipelinePlan& plan );
+    void showRate( const size_t count );
+    void clear();
+    static QString formatBytes( const size_t bytes );
+private:
+    SharedPtr<LazySequence<int>> _seq;
+    QTimer* _timer;
+    QElapsedTimer _clock;  // since the previous sample
+    Option<size_t> _lastCount; // empty until the first sample after the source of the count changed
+    size_t _progress;
+    bool _isFrozen;
+
+    QLabel* _rate;
+    QLabel* _cache;
+    QLabel* _trims;
+    QLabel* _depth;
+    QTableWidget* _stages;
+
+    static const int REFRESH_INTERVAL_MS = 500;
+};
+
+#endif // PERFPANEL_H
@@ -0,0 +1,51 @@
+#ifndef SEQUENCEMODEL_H
+#define SEQUENCEMODEL_H
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include "LazySequence.hpp"
+
+Q_DECLARE_METATYPE(SharedPtr<LazySequence<int>>)
+
+// sequences of the main list. a row is only rendered when the view asks for it, which it does for visible
+// rows only, and only the tail it shows is read from the cache. the text is kept until the sequence materializes more
+class SequenceModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit SequenceModel( QObject* parent = nullptr );
+public:
+    int rowCount( const QModelIndex& parent = QModelIndex() ) const override;
+    QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const override;
+public:
+    void append( const SharedPtr<LazySequence<int>>& seq );
+    void remove( const int row );
+    SharedPtr<LazySequence<int>> sequenceAt( const int row ) const;
+
+    // rows whose sequences materialized elements since they were rendered are reported to the views.
+    // derived sequences pull from their parents, so all rows are checked, which is a counter comparison per row
+    void refresh();
+
+    // while a sequence is materialized on another thread, rows show the text they had and don't touch sequences
+    void setFrozen( const bool isFrozen );
+    bool isFrozen() const { return _isFrozen; }
+
+    static const int SEQUENCE_ROLE = Qt::UserRole;
+    static const size_t SHOWN_COUNT = 15;
+private:
+    static QString render( const SharedPtr<LazySequence<int>>& seq );
+private:
+    struct Row
+    {
+        SharedPtr<LazySequence<int>> sequence;
+        mutable QString text;
+        mutable size_t renderedCount = 0;
+        mutable bool isRendered = false;
+    };
+    QList<Row> _rows;
+    bool _isFrozen = false;
+};
+
+#endif // SEQUENCEMODEL_H
@@ -0,0 +1,62 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include "util.hpp"
+
+// lazily evaluated coroutine which produces values with co_yield.
+// the body starts suspended and runs up to the next co_yield on every call of next().
+// the yielded value isn't copied: it's observed in place while the body is suspended
+template <typename T>
+class Coroutine
+{
+public:
+    class promise_type
+    {
+    public:
+        promise_type() : _current( nullptr ), _error() {}
+    public:
+        Coroutine<T> get_return_object();
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        // the yielded object lives until the body is resumed, so keeping its address is enough
+        std::suspend_always yield_value( const T& value ) noexcept;
+        std::suspend_always yield_value( T&& value ) noexcept;
+
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { _error = std::current_exception(); }
+        template <typename U>
+        void await_transform( U&& ) = delete; // only co_yield is supported
+    private:
+        friend class Coroutine<T>;
+        const T* _current;
+        std::exception_ptr _error;
+    };
+public:
+    Coroutine();
+
+    Coroutine( const Coroutine<T>& other ) = delete;
+    Coroutine<T>& operator=( const Coroutine<T>& other ) = delete;
+
+    Coroutine( Coroutine<T>&& other ) noexcept;
+    Coroutine<T>& operator=( Coroutine<T>&& other ) noexcept;
+
+    ~Coroutine();
+public:
+    bool next(); // false once the body has returned, rethrows whatever escaped the body
+    const T& getValue() const; // the value of the last co_yield
+    bool isDone() const;
+private:
+    using handle = std::coroutine_handle<promise_type>;
+
+    explicit Coroutine( handle coroutine ) : _coroutine( coroutine ) {}
+
+    handle _coroutine;
+};
+
+#include "Coroutine.tpp"
+
+#endif // COROUTINE_H
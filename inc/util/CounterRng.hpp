@@ -0,0 +1,61 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+#include <random>
+
+// stateless random numbers: every value is a hash of (seed, stream, counter),
+// so any of them can be recomputed in any order and on any thread.
+// the hash only uses 32-bit multiplications and shifts, which keeps it vectorizable
+class CounterRng
+{
+public:
+    CounterRng() : _seed(0) {}
+    explicit CounterRng( const uint64_t seed ) : _seed( seed ) {}
+
+    CounterRng( const CounterRng& other ) = default;
+    CounterRng& operator=( const CounterRng& other ) = default;
+
+    ~CounterRng() = default;
+public:
+    static uint64_t randomSeed() {
+        std::random_device device;
+        return (static_cast<uint64_t>( device() ) << 32) | device();
+    }
+
+    // lowbias32 finalizer, every input bit affects every output bit
+    static uint32_t mix( uint32_t value ) {
+        value ^= value >> 16;
+        value *= 0x7feb352du;
+        value ^= value >> 15;
+        value *= 0x846ca68bu;
+        value ^= value >> 16;
+        return value;
+    }
+
+    // raw 32 random bits of the counter within a stream key
+    static uint32_t at( const uint32_t key, const uint32_t counter ) {
+        return mix( key + counter * 0x9e3779b9u );
+    }
+public:
+    uint64_t getSeed() const { return _seed; }
+
+    // key of an independent stream, computed once and reused for all of its counters
+    uint32_t streamKey( const uint64_t stream ) const {
+        uint32_t key = mix( static_cast<uint32_t>( _seed ) ^ 0x85ebca6bu );
+        key = mix( key ^ static_cast<uint32_t>( _seed >> 32 ));
+        key = mix( key ^ static_cast<uint32_t>( stream ));
+        return mix( key ^ static_cast<uint32_t>( stream >> 32 ));
+    }
+
+    // uniform value in [-amp, amp), scale being amp / 2^23. top 24 bits convert to float exactly,
+    // so vectorized code doing the same steps gets bitwise equal results
+    static float symmetric( const uint32_t bits, const float scale ) {
+        return static_cast<float>( static_cast<int32_t>( bits >> 8 ) - 0x800000 ) * scale;
+    }
+    static float symmetricScale( const float amp ) { return amp / 8388608.0f; }
+private:
+    uint64_t _seed;
+};
+
+#endif // COUNTER_RNG_H
@@ -0,0 +1,65 @@
+#ifndef SCAN_BUDGET_H
+#define SCAN_BUDGET_H
+
+#include <chrono>
+#include <cstddef>
+
+enum class ScanStatus {
+    FOUND = 0,
+    BUDGET_EXHAUSTED = 1, // scanning stopped early, but can be resumed by the next call
+    FINISHED = 2
+};
+
+// limits the work a single call is allowed to spend scanning the parent sequence.
+// zero in any of the fields means that the corresponding limit is not applied
+class ScanBudget
+{
+public:
+    ScanBudget() : _steps(0), _time(0) {}
+    explicit ScanBudget( const size_t steps ) : _steps(steps), _time(0) {}
+    explicit ScanBudget( const std::chrono::nanoseconds& time ) : _steps(0), _time(time) {}
+    ScanBudget( const size_t steps, const std::chrono::nanoseconds& time ) : _steps(steps), _time(time) {}
+
+    ScanBudget( const ScanBudget& other ) = default;
+    ScanBudget& operator=( const ScanBudget& other ) = default;
+
+    ~ScanBudget() = default;
+public:
+    static ScanBudget unbounded() { return ScanBudget(); }
+
+    size_t getSteps() const { return _steps; }
+    std::chrono::nanoseconds getTime() const { return _time; }
+    bool isBounded() const { return _steps != 0 || _time.count() != 0; }
+public:
+    // tracks the consumption of a budget over a single call
+    class Meter
+    {
+    public:
+        Meter( const ScanBudget& budget )
+        : _budget( budget ), _spent(0)
+        , _start( budget._time.count() != 0 ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point() ) {}
+    public:
+        // registers one more step and reports whether the budget allows to take another one
+        bool step() {
+            _spent++;
+            if (_budget._steps != 0 && _spent >= _budget._steps) {
+                return false;
+            }
+            if (_budget._time.count() != 0 && _spent % TIME_CHECK_INTERVAL == 0) {
+                return std::chrono::steady_clock::now() - _start < _budget._time;
+            }
+            return true;
+        }
+        size_t getSpent() const { return _spent; }
+    private:
+        static const size_t TIME_CHECK_INTERVAL = 16; // reading the clock on every step costs as much as a cheap predicate
+        const ScanBudget& _budget;
+        size_t _spent;
+        std::chrono::steady_clock::time_point _start;
+    };
+private:
+    size_t _steps;
+    std::chrono::nanoseconds _time;
+};
+
+#endif // SCAN_BUDGET_H
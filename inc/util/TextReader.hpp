@@ -0,0 +1,39 @@
+#ifndef TEXT_READER_H
+#define TEXT_READER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "util.hpp"
+
+// splits a text file into tokens separated by whitespace, commas and semicolons. the file is read in blocks
+// of a fixed size, tokens are views into the block, so nothing is allocated per token or per line
+class TextReader
+{
+public:
+    TextReader( const std::string& path, const size_t blockSize = DEFAULT_BLOCK_SIZE ); // tokens must be shorter than a block
+
+    TextReader( const TextReader& other ) = delete;
+    TextReader& operator=( const TextReader& other ) = delete;
+
+    ~TextReader();
+public:
+    bool nextToken( std::string_view& token ); // false at eof. the view is valid until the next call
+    size_t getBlockSize() const { return _capacity; }
+
+    static const size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+private:
+    bool refill(); // moves the unread part to the front of the block and reads after it
+    static bool isSeparator( const char c );
+private:
+    int _fd;
+    char* _buffer;
+    size_t _capacity;
+    size_t _begin; // first unread byte
+    size_t _end;   // end of the bytes read
+    bool _isEof;
+};
+
+#include "TextReader.tpp"
+
+#endif // TEXT_READER_H
@@ -0,0 +1,105 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// chrome trace_event recording of generator pulls. it's only compiled in with LAZY_SEQUENCE_TRACE defined,
+// otherwise LAZY_TRACE expands to nothing. open the dump in chrome://tracing or ui.perfetto.dev
+
+#ifdef LAZY_SEQUENCE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include "util.hpp"
+
+struct TraceEvent
+{
+    const char* name;     // static string, never copied
+    const void* instance; // the generator or sequence the event belongs to
+    uint64_t timestamp;   // nanoseconds since the tracer was created
+    char phase;           // 'B' or 'E'
+};
+
+// events of a single thread. only the owning thread writes, the oldest events are overwritten once it's full
+class TraceBuffer
+{
+public:
+    TraceBuffer( const size_t capacity, const uint32_t threadId );
+
+    TraceBuffer( const TraceBuffer& other ) = delete;
+    TraceBuffer& operator=( const TraceBuffer& other ) = delete;
+
+    ~TraceBuffer();
+public:
+    void record( const char* name, const void* instance, const char phase );
+    void clear();
+
+    size_t getSize() const;
+    const TraceEvent& operator[]( const size_t index ) const; // from the oldest event
+    uint32_t getThreadId() const { return _threadId; }
+private:
+    TraceEvent* _events;
+    size_t _capacity;
+    std::atomic<size_t> _written;
+    uint32_t _threadId;
+};
+
+// owns the buffers of every thread which has recorded anything, so they outlive their threads
+class Tracer
+{
+public:
+    static Tracer& instance();
+
+    Tracer( const Tracer& other ) = delete;
+    Tracer& operator=( const Tracer& other ) = delete;
+
+    ~Tracer();
+public:
+    TraceBuffer& threadBuffer();
+    uint64_t now() const;
+
+    // both expect the traced pipelines to be idle
+    void dump( std::ostream& out );
+    void dump( const std::string& path );
+    void clear();
+
+    static const size_t BUFFER_CAPACITY = 1 << 16;
+private:
+    Tracer();
+private:
+    std::chrono::steady_clock::time_point _start;
+    std::mutex _lock;
+    TraceBuffer** _buffers;
+    size_t _bufferCount;
+    size_t _bufferCapacity;
+};
+
+// records the begin event on construction and the end event on destruction, exceptions included
+class TraceScope
+{
+public:
+    TraceScope( const char* name, const void* instance );
+
+    TraceScope( const TraceScope& other ) = delete;
+    TraceScope& operator=( const TraceScope& other ) = delete;
+
+    ~TraceScope();
+private:
+    TraceBuffer& _buffer;
+    const char* _name;
+    const void* _instance;
+};
+
+#define LAZY_TRACE() TraceScope lazyTraceScope( __PRETTY_FUNCTION__, this )
+
+#include "Trace.tpp"
+
+#else
+
+#define LAZY_TRACE() ((void)0)
+
+#endif // LAZY_SEQUENCE_TRACE
+
+#endif // TRACE_H
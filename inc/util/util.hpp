@@ -31,8 +31,15 @@ public:
         UNKNOWN_ORDINALITY = 16,
         INVALID_ITERATOR = 17, 
         ITERATOR_AT_INFINITY = 18,
-        INCONSISTENT_CHUNK_ACCESS = 19
+        INCONSISTENT_CHUNK_ACCESS = 19,
+        SCAN_BUDGET_EXHAUSTED = 20,
+        SNAPSHOT_MISMATCH = 21,
+        UNSUPPORTED_SNAPSHOT = 22,
+        CONSUMER_LAGGED = 23,
+        SHARED_PARENT = 24
     };
+private:
+    ErrorCode code = ErrorCode::UNKNOWN_ERROR; // unless constructed from a code
 public:
     explicit Exception( std::exception& ex ) : ex(ex) {
         this->ex = ex;
@@ -48,6 +55,7 @@ public:
     }
     explicit Exception( ErrorCode code ) {
         this->ex = std::exception();
+        this->code = code;
         switch ( code ) {
         case ErrorCode::SUCCESS:
             this->message = "Success!";
@@ -109,6 +117,21 @@ public:
         case ErrorCode::INCONSISTENT_CHUNK_ACCESS:
             this->message = "Error. Indexed access is prohibited due to non-deterministic nature of chunk generation.";
             break;
+        case ErrorCode::SCAN_BUDGET_EXHAUSTED:
+            this->message = "Error. Scan budget exhausted before the next element was found, the scan can be resumed.";
+            break;
+        case ErrorCode::SNAPSHOT_MISMATCH:
+            this->message = "Error. Snapshot is damaged, of another version or made for a differently built sequence.";
+            break;
+        case ErrorCode::UNSUPPORTED_SNAPSHOT:
+            this->message = "Error. State of this generator or element type can not be saved to a snapshot.";
+            break;
+        case ErrorCode::CONSUMER_LAGGED:
+            this->message = "Error. Derived sequence fell too far behind its parent, which can't recompute the element.";
+            break;
+        case ErrorCode::SHARED_PARENT:
+            this->message = "Error. A parent of the sequence is read by other sequences as well, so it can't be read from another thread.";
+            break;
         default:
             this->message = "Unknown error.";
             break;
@@ -122,6 +145,9 @@ public:
     const char* what() const noexcept override {
         return this->message.c_str();
     }
+    ErrorCode getCode() const noexcept {
+        return this->code;
+    }
 };
 
 #endif // UTILITY_H
\ No newline at end of file
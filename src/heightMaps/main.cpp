@@ -1,55 +1,153 @@
-#include "LazySequence.hpp"
-#include "HeightMapGenerator.hpp"
+#include "HeightMapWorld.hpp"
+#include "HeightMapWriter.hpp"
+#include <cstring>
 #include <iostream>
-#include <fstream>
-
-int main() {
-    float startValue;
-    size_t size;
-    float amplitude;
-    size_t numChunks;
-    
+#include <string>
+
+// usage: heightMaps [--seed N] [--base H] [--size N] [--amp A] [--width TILES] [--height TILES]
+//                   [--format png|pgm|raw|csv] [--out PATH] [--range LOW HIGH]
+// without arguments the parameters are asked for interactively
+
+struct Options
+{
+    uint64_t seed = CounterRng::randomSeed();
+    float base = 0.0f; // initial height the map spreads around
+    size_t size = 16;
+    float amplitude = 1.0f;
+    size_t tilesWide = 16;
+    size_t tilesHigh = 16;
+    HeightMapFormat format = HeightMapFormat::PNG;
+    std::string path;
+    bool hasRange = false;
+    HeightRange range { 0.0f, 0.0f };
+};
+
+HeightMapFormat parseFormat( const std::string& name ) {
+    if (name == "png") { return HeightMapFormat::PNG; }
+    if (name == "pgm") { return HeightMapFormat::PGM; }
+    if (name == "raw") { return HeightMapFormat::RAW; }
+    if (name == "csv") { return HeightMapFormat::CSV; }
+    throw Exception( Exception::ErrorCode::INVALID_INPUT );
+}
+
+const char* extension( const HeightMapFormat format ) {
+    switch (format) {
+    case HeightMapFormat::PGM: return "pgm";
+    case HeightMapFormat::RAW: return "raw";
+    case HeightMapFormat::CSV: return "csv";
+    default:                   return "png";
+    }
+}
+
+Options parseArgs( int argc, char** argv ) {
+    Options options;
+    for (int index = 1; index < argc; index++) {
+        auto arg = std::string( argv[index] );
+        auto needs = [&]( int count ) {
+            if (index + count >= argc) {
+                throw Exception( Exception::ErrorCode::INVALID_INPUT );
+            }
+        };
+        if (arg == "--seed")        { needs(1); options.seed = std::stoull( argv[++index] ); }
+        else if (arg == "--base")   { needs(1); options.base = std::stof( argv[++index] ); }
+        else if (arg == "--size")   { needs(1); options.size = std::stoul( argv[++index] ); }
+        else if (arg == "--amp")    { needs(1); options.amplitude = std::stof( argv[++index] ); }
+        else if (arg == "--width")  { needs(1); options.tilesWide = std::stoul( argv[++index] ); }
+        else if (arg == "--height") { needs(1); options.tilesHigh = std::stoul( argv[++index] ); }
+        else if (arg == "--format") { needs(1); options.format = parseFormat( argv[++index] ); }
+        else if (arg == "--out")    { needs(1); options.path = argv[++index]; }
+        else if (arg == "--range") {
+            needs(2);
+            options.range.low = std::stof( argv[++index] );
+            options.range.high = std::stof( argv[++index] );
+            options.hasRange = true;
+        } else {
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
+        }
+    }
+    return options;
+}
+
+Options askOptions() {
+    Options options;
+    std::string format;
+
     std::cout << "Enter initial height value: ";
-    std::cin >> startValue;
-    
-    std::cout << "Enter map size (NxN): ";
-    std::cin >> size;
-    
+    std::cin >> options.base;
+
+    std::cout << "Enter tile size (NxN): ";
+    std::cin >> options.size;
+
     std::cout << "Enter height variation amplitude: ";
-    std::cin >> amplitude;
-    
-    std::cout << "Enter number of chunks to generate: ";
-    std::cin >> numChunks;
-    
-    auto gen = HeightMapGenerator(startValue, size, amplitude);
-    
-    ArraySequence<chunk> chunks;
-    for (size_t chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx) {
-        chunks.append(gen.getNext());
-    }
-    
-    std::ofstream csvFile("../src/heightMaps/heightmap.csv");
-    
-    for (size_t row = 0; row < size; ++row) {
-        for (size_t chunkIdx = 0; chunkIdx < numChunks; ++chunkIdx) {
-            for (size_t col = 0; col < size; ++col) {
-                csvFile << chunks[chunkIdx][col][row];
-                if (!(chunkIdx == numChunks - 1 && col == size - 1)) csvFile << ",";
+    std::cin >> options.amplitude;
+
+    std::cout << "Enter number of tiles horizontally and vertically: ";
+    std::cin >> options.tilesWide >> options.tilesHigh;
+
+    std::cout << "Enter output format (png, pgm, raw, csv): ";
+    std::cin >> format;
+    options.format = parseFormat( format );
+    return options;
+}
+
+// integer formats need the range before the first row, it's found by a pass which doesn't keep any tiles
+HeightRange findRange( const HeightMapWorld& world, const Options& options ) {
+    HeightRange range { 0.0f, 0.0f };
+    bool isFirst = true;
+    for (size_t tileY = 0; tileY < options.tilesHigh; tileY++) {
+        for (size_t tileX = 0; tileX < options.tilesWide; tileX++) {
+            auto tile = world.generate( static_cast<int64_t>( tileX ), static_cast<int64_t>( tileY ));
+            for (size_t cell = 0; cell < tile.getCount(); cell++) {
+                float value = tile.getData()[cell];
+                if (isFirst || value < range.low)  { range.low = value; }
+                if (isFirst || value > range.high) { range.high = value; }
+                isFirst = false;
             }
         }
-        csvFile << "\n";
     }
-    
-    csvFile.close();
-    std::cout << "Height map saved to ../src/heightMaps/heightmap.csv\n";
-    
-    std::cout << "Generating PNG visualization...\n";
-    int result = system("python3 ../src/heightMaps/plot_heightmap.py ../src/heightMaps/heightmap.csv");
-    if (result == 0) {
-        std::cout << "PNG visualization generated successfully\n";
-    } else {
-        std::cout << "Warning: Could not generate PNG (python3/matplotlib required)\n";
+    return range;
+}
+
+int main( int argc, char** argv ) {
+    try {
+        Options options = argc > 1 ? parseArgs( argc, argv ) : askOptions();
+        if (options.path.empty()) {
+            options.path = std::string( "../src/heightMaps/heightmap." ) + extension( options.format );
+        }
+
+        HeightMapWorld world( options.seed, options.size, options.amplitude, HeightMapWorld::DEFAULT_CACHE_CAPACITY, options.base );
+        // a single band of tiles is alive at a time
+        world.setCacheCapacity( options.tilesWide * (options.size * options.size * sizeof(float) + sizeof(chunk)
+                              + LruCache<TileCoord, SharedPtr<chunk>, TileCoordHash>::ENTRY_OVERHEAD ));
+
+        bool needsRange = options.format == HeightMapFormat::PNG || options.format == HeightMapFormat::PGM;
+        if (needsRange && !options.hasRange) {
+            options.range = findRange( world, options );
+        }
+
+        const size_t width = options.tilesWide * options.size;
+        auto writer = makeHeightMapWriter( options.format, options.path, width, options.tilesHigh * options.size, options.range );
+        column rowBuffer( static_cast<int>( width ));
+        for (size_t col = 0; col < width; col++) {
+            rowBuffer.append( 0.0f );
+        }
+        float* row = rowBuffer.getData();
+        for (size_t tileY = 0; tileY < options.tilesHigh; tileY++) {
+            for (size_t cellY = 0; cellY < options.size; cellY++) {
+                for (size_t tileX = 0; tileX < options.tilesWide; tileX++) {
+                    auto tile = world.get( static_cast<int64_t>( tileX ), static_cast<int64_t>( tileY ));
+                    std::memcpy( row + tileX * options.size, tile->row( cellY ), options.size * sizeof(float) );
+                }
+                writer->writeRow( row );
+            }
+        }
+        writer->finish();
+
+        std::cout << "Height map " << width << "x" << options.tilesHigh * options.size
+                  << " (seed " << options.seed << ") saved to " << options.path << "\n";
+    } catch ( std::exception& ex ) {
+        std::cout << ex.what() << "\n";
+        return 1;
     }
-    
     return 0;
-}
\ No newline at end of file
+}
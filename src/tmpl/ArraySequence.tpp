@@ -157,6 +157,10 @@ Sequence<T>* ArraySequence<T>::concat( const Sequence<T>& other ) {
 
 template <typename T>
 void ArraySequence<T>::map( const std::function<T(T)>& func ) {
+    // rewrapping func into DynamicArray's signature would hide the kernel operation from it
+    if (BatchKernels<T>::tryMap( this->array.getData(), this->array.getSize(), func )) {
+        return;
+    }
     this->array.map(func);
 }
 
@@ -193,6 +197,16 @@ size_t ArraySequence<T>::getSize() const {
     return this->array.getSize();
 }
 
+template <typename T>
+T* ArraySequence<T>::getData() {
+    return this->array.getData();
+}
+
+template <typename T>
+const T* ArraySequence<T>::getData() const {
+    return this->array.getData();
+}
+
 template <typename T>
 Sequence<T>* ArraySequence<T>::appendImmutable( const T& value ) const {
     try {
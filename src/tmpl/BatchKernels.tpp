@@ -0,0 +1,376 @@
+#include <array>
+
+// integers are computed unsigned, so an overflow wraps the same way as in the vector lanes instead of being UB.
+// types narrower than int are widened to unsigned first, otherwise they would be promoted to a signed int again
+template <typename T>
+T ArithmeticOp<T>::operator()( T value ) const {
+    if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+        using Unsigned = std::conditional_t<(sizeof(T) < sizeof(unsigned)), unsigned, std::make_unsigned_t<T>>;
+        Unsigned lhs = static_cast<Unsigned>( value );
+        Unsigned rhs = static_cast<Unsigned>( _operand );
+        switch (_kind) {
+        case Kind::ADD:
+            return static_cast<T>( lhs + rhs );
+        case Kind::SUB:
+            return static_cast<T>( lhs - rhs );
+        default:
+            return static_cast<T>( lhs * rhs );
+        }
+    } else {
+        switch (_kind) {
+        case Kind::ADD:
+            return value + _operand;
+        case Kind::SUB:
+            return value - _operand;
+        default:
+            return value * _operand;
+        }
+    }
+}
+
+template <typename T>
+bool ComparisonOp<T>::operator()( T value ) const {
+    switch (_kind) {
+    case Kind::LESS:
+        return value < _operand;
+    case Kind::LESS_EQUAL:
+        return value <= _operand;
+    case Kind::GREATER:
+        return value > _operand;
+    case Kind::GREATER_EQUAL:
+        return value >= _operand;
+    case Kind::EQUAL:
+        return value == _operand;
+    default:
+        return value != _operand;
+    }
+}
+
+#ifdef BATCH_KERNELS_X86
+
+// row mask -> indices of the selected lanes moved to the front, used by the avx2 compress-store
+inline const std::array<std::array<int32_t, 8>, 256>& batchCompressTable() {
+    static const std::array<std::array<int32_t, 8>, 256> table = [] {
+        std::array<std::array<int32_t, 8>, 256> res {};
+        for (size_t mask = 0; mask < 256; mask++) {
+            size_t kept = 0;
+            for (int32_t lane = 0; lane < 8; lane++) {
+                if (mask & (1u << lane)) {
+                    res[mask][kept++] = lane;
+                }
+            }
+        }
+        return res;
+    }();
+    return table;
+}
+
+// sse2 is the x86-64 baseline, so these kernels need no target attributes
+inline __m128i batchMulSse2( const __m128i a, const __m128i b ) {
+    // sse2 has no 32-bit low multiplication, the low halves of two unsigned products are the same bits
+    __m128i even = _mm_mul_epu32( a, b );
+    __m128i odd  = _mm_mul_epu32( _mm_srli_si128( a, 4 ), _mm_srli_si128( b, 4 ));
+    return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE(0, 0, 2, 0) )
+                             , _mm_shuffle_epi32( odd,  _MM_SHUFFLE(0, 0, 2, 0) ));
+}
+
+inline void batchMapSse2( float* data, const size_t size, const ArithmeticOp<float>& op ) {
+    const __m128 operand = _mm_set1_ps( op.getOperand() );
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        __m128 value = _mm_loadu_ps( data + index );
+        switch (op.getKind()) {
+        case ArithmeticOp<float>::Kind::ADD: value = _mm_add_ps( value, operand ); break;
+        case ArithmeticOp<float>::Kind::SUB: value = _mm_sub_ps( value, operand ); break;
+        default:                             value = _mm_mul_ps( value, operand ); break;
+        }
+        _mm_storeu_ps( data + index, value );
+    }
+    for (; index < size; index++) {
+        data[index] = op( data[index] );
+    }
+}
+
+inline void batchMapSse2( int32_t* data, const size_t size, const ArithmeticOp<int32_t>& op ) {
+    const __m128i operand = _mm_set1_epi32( op.getOperand() );
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        __m128i value = _mm_loadu_si128( reinterpret_cast<const __m128i*>( data + index ));
+        switch (op.getKind()) {
+        case ArithmeticOp<int32_t>::Kind::ADD: value = _mm_add_epi32( value, operand ); break;
+        case ArithmeticOp<int32_t>::Kind::SUB: value = _mm_sub_epi32( value, operand ); break;
+        default:                               value = batchMulSse2( value, operand ); break;
+        }
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( data + index ), value );
+    }
+    for (; index < size; index++) {
+        data[index] = op( data[index] );
+    }
+}
+
+inline int batchMaskSse2( const __m128 value, const ComparisonOp<float>& op ) {
+    const __m128 operand = _mm_set1_ps( op.getOperand() );
+    switch (op.getKind()) {
+    case ComparisonOp<float>::Kind::LESS:          return _mm_movemask_ps( _mm_cmplt_ps( value, operand ));
+    case ComparisonOp<float>::Kind::LESS_EQUAL:    return _mm_movemask_ps( _mm_cmple_ps( value, operand ));
+    case ComparisonOp<float>::Kind::GREATER:       return _mm_movemask_ps( _mm_cmpgt_ps( value, operand ));
+    case ComparisonOp<float>::Kind::GREATER_EQUAL: return _mm_movemask_ps( _mm_cmpge_ps( value, operand ));
+    case ComparisonOp<float>::Kind::EQUAL:         return _mm_movemask_ps( _mm_cmpeq_ps( value, operand ));
+    default:                                       return _mm_movemask_ps( _mm_cmpneq_ps( value, operand ));
+    }
+}
+
+inline int batchMaskSse2( const __m128i value, const ComparisonOp<int32_t>& op ) {
+    const __m128i operand = _mm_set1_epi32( op.getOperand() );
+    auto mask = [](const __m128i bits) { return _mm_movemask_ps( _mm_castsi128_ps( bits )); };
+    switch (op.getKind()) {
+    case ComparisonOp<int32_t>::Kind::LESS:          return mask( _mm_cmplt_epi32( value, operand ));
+    case ComparisonOp<int32_t>::Kind::LESS_EQUAL:    return mask( _mm_cmpgt_epi32( value, operand )) ^ 0xF;
+    case ComparisonOp<int32_t>::Kind::GREATER:       return mask( _mm_cmpgt_epi32( value, operand ));
+    case ComparisonOp<int32_t>::Kind::GREATER_EQUAL: return mask( _mm_cmplt_epi32( value, operand )) ^ 0xF;
+    case ComparisonOp<int32_t>::Kind::EQUAL:         return mask( _mm_cmpeq_epi32( value, operand ));
+    default:                                         return mask( _mm_cmpeq_epi32( value, operand )) ^ 0xF;
+    }
+}
+
+// sse2 has no variable lane permutation, so the mask drives a short scalar compaction
+template <typename T, typename Vector>
+inline size_t batchCompressSse2( T* data, const size_t size, const ComparisonOp<T>& op, Vector (*load)( const T* ) ) {
+    size_t kept = 0;
+    size_t index = 0;
+    for (; index + 4 <= size; index += 4) {
+        T lanes[4] = { data[index], data[index + 1], data[index + 2], data[index + 3] };
+        int mask = batchMaskSse2( load( lanes ), op );
+        for (size_t lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) {
+                data[kept++] = lanes[lane];
+            }
+        }
+    }
+    for (; index < size; index++) {
+        if (op( data[index] )) {
+            data[kept++] = data[index];
+        }
+    }
+    return kept;
+}
+
+inline size_t batchWhereSse2( float* data, const size_t size, const ComparisonOp<float>& op ) {
+    return batchCompressSse2<float, __m128>( data, size, op, []( const float* lanes ) { return _mm_loadu_ps( lanes ); } );
+}
+
+inline size_t batchWhereSse2( int32_t* data, const size_t size, const ComparisonOp<int32_t>& op ) {
+    return batchCompressSse2<int32_t, __m128i>( data, size, op, []( const int32_t* lanes ) {
+        return _mm_loadu_si128( reinterpret_cast<const __m128i*>( lanes ));
+    });
+}
+
+// avx2 kernels are compiled for avx2 regardless of the global flags and only called after a cpu check.
+// lambdas don't inherit the target attribute, so the loops are spelled out
+__attribute__((target("avx2")))
+inline void batchMapAvx2( float* data, const size_t size, const ArithmeticOp<float>& op ) {
+    const __m256 operand = _mm256_set1_ps( op.getOperand() );
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        __m256 value = _mm256_loadu_ps( data + index );
+        switch (op.getKind()) {
+        case ArithmeticOp<float>::Kind::ADD: value = _mm256_add_ps( value, operand ); break;
+        case ArithmeticOp<float>::Kind::SUB: value = _mm256_sub_ps( value, operand ); break;
+        default:                             value = _mm256_mul_ps( value, operand ); break;
+        }
+        _mm256_storeu_ps( data + index, value );
+    }
+    for (; index < size; index++) {
+        data[index] = op( data[index] );
+    }
+}
+
+__attribute__((target("avx2")))
+inline void batchMapAvx2( int32_t* data, const size_t size, const ArithmeticOp<int32_t>& op ) {
+    const __m256i operand = _mm256_set1_epi32( op.getOperand() );
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        __m256i value = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + index ));
+        switch (op.getKind()) {
+        case ArithmeticOp<int32_t>::Kind::ADD: value = _mm256_add_epi32( value, operand ); break;
+        case ArithmeticOp<int32_t>::Kind::SUB: value = _mm256_sub_epi32( value, operand ); break;
+        default:                               value = _mm256_mullo_epi32( value, operand ); break;
+        }
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( data + index ), value );
+    }
+    for (; index < size; index++) {
+        data[index] = op( data[index] );
+    }
+}
+
+__attribute__((target("avx2")))
+inline int batchMaskAvx2( const __m256 value, const ComparisonOp<float>& op ) {
+    const __m256 operand = _mm256_set1_ps( op.getOperand() );
+    switch (op.getKind()) {
+    case ComparisonOp<float>::Kind::LESS:          return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_LT_OQ ));
+    case ComparisonOp<float>::Kind::LESS_EQUAL:    return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_LE_OQ ));
+    case ComparisonOp<float>::Kind::GREATER:       return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_GT_OQ ));
+    case ComparisonOp<float>::Kind::GREATER_EQUAL: return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_GE_OQ ));
+    case ComparisonOp<float>::Kind::EQUAL:         return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_EQ_OQ ));
+    default:                                       return _mm256_movemask_ps( _mm256_cmp_ps( value, operand, _CMP_NEQ_UQ ));
+    }
+}
+
+__attribute__((target("avx2")))
+inline int batchMaskAvx2( const __m256i value, const ComparisonOp<int32_t>& op ) {
+    const __m256i operand = _mm256_set1_epi32( op.getOperand() );
+    switch (op.getKind()) {
+    case ComparisonOp<int32_t>::Kind::LESS:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( operand, value )));
+    case ComparisonOp<int32_t>::Kind::LESS_EQUAL:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( value, operand ))) ^ 0xFF;
+    case ComparisonOp<int32_t>::Kind::GREATER:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( value, operand )));
+    case ComparisonOp<int32_t>::Kind::GREATER_EQUAL:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( operand, value ))) ^ 0xFF;
+    case ComparisonOp<int32_t>::Kind::EQUAL:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( value, operand )));
+    default:
+        return _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( value, operand ))) ^ 0xFF;
+    }
+}
+
+// compress-store: selected lanes are permuted to the front and the whole vector is stored at the write cursor.
+// the write cursor never overtakes the read one, so the extra lanes only land on already loaded elements
+__attribute__((target("avx2")))
+inline size_t batchWhereAvx2( float* data, const size_t size, const ComparisonOp<float>& op ) {
+    const auto& table = batchCompressTable();
+    size_t kept = 0;
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        __m256 value = _mm256_loadu_ps( data + index );
+        int mask = batchMaskAvx2( value, op );
+        __m256i lanes = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( table[mask].data() ));
+        _mm256_storeu_ps( data + kept, _mm256_permutevar8x32_ps( value, lanes ));
+        kept += __builtin_popcount( mask );
+    }
+    for (; index < size; index++) {
+        if (op( data[index] )) {
+            data[kept++] = data[index];
+        }
+    }
+    return kept;
+}
+
+__attribute__((target("avx2")))
+inline size_t batchWhereAvx2( int32_t* data, const size_t size, const ComparisonOp<int32_t>& op ) {
+    const auto& table = batchCompressTable();
+    size_t kept = 0;
+    size_t index = 0;
+    for (; index + 8 <= size; index += 8) {
+        __m256i value = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( data + index ));
+        int mask = batchMaskAvx2( value, op );
+        __m256i lanes = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( table[mask].data() ));
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( data + kept ), _mm256_permutevar8x32_epi32( value, lanes ));
+        kept += __builtin_popcount( mask );
+    }
+    for (; index < size; index++) {
+        if (op( data[index] )) {
+            data[kept++] = data[index];
+        }
+    }
+    return kept;
+}
+
+#endif // BATCH_KERNELS_X86
+
+template <typename T>
+KernelIsa BatchKernels<T>::getBestIsa() {
+#ifdef BATCH_KERNELS_X86
+    static const KernelIsa best = __builtin_cpu_supports("avx2") ? KernelIsa::AVX2 : KernelIsa::SSE2;
+    return isVectorizable ? best : KernelIsa::SCALAR;
+#else
+    return KernelIsa::SCALAR;
+#endif
+}
+
+template <typename T>
+void BatchKernels<T>::map( T* data, const size_t size, const ArithmeticOp<T>& op ) {
+    map( data, size, op, getBestIsa() );
+}
+
+template <typename T>
+void BatchKernels<T>::map( T* data, const size_t size, const ArithmeticOp<T>& op, const KernelIsa isa ) {
+#ifdef BATCH_KERNELS_X86
+    if constexpr (isVectorizable) {
+        auto usable = isa < getBestIsa() ? isa : getBestIsa();
+        if (usable == KernelIsa::AVX2) {
+            batchMapAvx2( data, size, op );
+            return;
+        } else if (usable == KernelIsa::SSE2) {
+            batchMapSse2( data, size, op );
+            return;
+        }
+    }
+#endif
+    (void)isa;
+    mapScalar( data, size, op );
+}
+
+template <typename T>
+size_t BatchKernels<T>::where( T* data, const size_t size, const ComparisonOp<T>& op ) {
+    return where( data, size, op, getBestIsa() );
+}
+
+template <typename T>
+size_t BatchKernels<T>::where( T* data, const size_t size, const ComparisonOp<T>& op, const KernelIsa isa ) {
+#ifdef BATCH_KERNELS_X86
+    if constexpr (isVectorizable) {
+        auto usable = isa < getBestIsa() ? isa : getBestIsa();
+        if (usable == KernelIsa::AVX2) {
+            return batchWhereAvx2( data, size, op );
+        } else if (usable == KernelIsa::SSE2) {
+            return batchWhereSse2( data, size, op );
+        }
+    }
+#endif
+    (void)isa;
+    return whereScalar( data, size, op );
+}
+
+template <typename T>
+template <typename Signature>
+bool BatchKernels<T>::tryMap( T* data, const size_t size, const std::function<Signature>& func ) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (auto op = func.template target<ArithmeticOp<T>>()) {
+            map( data, size, *op );
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+template <typename Signature>
+bool BatchKernels<T>::tryWhere( T* data, size_t& size, const std::function<Signature>& func ) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        if (auto op = func.template target<ComparisonOp<T>>()) {
+            size = where( data, size, *op );
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void BatchKernels<T>::mapScalar( T* data, const size_t size, const ArithmeticOp<T>& op ) {
+    for (size_t index = 0; index < size; index++) {
+        data[index] = op( data[index] );
+    }
+}
+
+template <typename T>
+size_t BatchKernels<T>::whereScalar( T* data, const size_t size, const ComparisonOp<T>& op ) {
+    size_t kept = 0;
+    for (size_t index = 0; index < size; index++) {
+        if (op( data[index] )) {
+            data[kept++] = data[index];
+        }
+    }
+    return kept;
+}
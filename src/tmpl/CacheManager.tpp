@@ -0,0 +1,127 @@
+inline CacheEntry::CacheEntry()
+: _bytes(0), _referenced( true ), _thread( std::this_thread::get_id() ), _prev( nullptr ), _next( nullptr ) {
+    CacheManager::instance().enroll( this );
+}
+
+inline CacheEntry::~CacheEntry() {
+    CacheManager::instance().withdraw( this );
+}
+
+inline void CacheEntry::update( const size_t bytes ) {
+    _referenced.store( true, std::memory_order_relaxed );
+    if (_thread.load( std::memory_order_relaxed ) != std::this_thread::get_id()) {
+        _thread.store( std::this_thread::get_id(), std::memory_order_relaxed );
+    }
+    size_t old = _bytes.exchange( bytes, std::memory_order_relaxed );
+    if (old != bytes) {
+        CacheManager::instance().charge( old, bytes );
+    }
+}
+
+inline CacheManager& CacheManager::instance() {
+    static CacheManager manager;
+    return manager;
+}
+
+inline CacheManager::CacheManager()
+: _lock(), _head( nullptr ), _hand( nullptr ), _count(0), _budget(0), _bytes(0), _evictions(0), _evictedBytes(0) {}
+
+inline void CacheManager::setBudget( const size_t bytes ) {
+    _budget.store( bytes, std::memory_order_relaxed );
+    if (bytes != 0 && getBytes() > bytes) {
+        enforce();
+    }
+}
+
+inline size_t CacheManager::getCount() const {
+    std::lock_guard<std::mutex> guard( _lock );
+    return _count;
+}
+
+// the caches of other threads change under the lock as well, so the same rule as for eviction applies
+inline ArraySequence<CacheFootprint> CacheManager::report() const {
+    std::lock_guard<std::mutex> guard( _lock );
+    const auto self = std::this_thread::get_id();
+    ArraySequence<CacheFootprint> res;
+    for (CacheEntry* entry = _head; entry != nullptr; entry = entry->_next) {
+        CacheFootprint footprint;
+        if (entry->_thread.load( std::memory_order_relaxed ) == self) {
+            footprint = entry->getFootprint();
+        } else {
+            footprint.owner = entry->getOwner();
+        }
+        footprint.cacheBytes = entry->getBytes();
+        res.append( footprint );
+    }
+    return res;
+}
+
+// the list is doubly linked, so caches come and go in constant time
+inline void CacheManager::enroll( CacheEntry* entry ) {
+    std::lock_guard<std::mutex> guard( _lock );
+    entry->_next = _head;
+    if (_head != nullptr) {
+        _head->_prev = entry;
+    }
+    _head = entry;
+    _count++;
+}
+
+inline void CacheManager::withdraw( CacheEntry* entry ) {
+    std::lock_guard<std::mutex> guard( _lock );
+    if (_hand == entry) {
+        _hand = entry->_next;
+    }
+    if (entry->_prev != nullptr) {
+        entry->_prev->_next = entry->_next;
+    } else {
+        _head = entry->_next;
+    }
+    if (entry->_next != nullptr) {
+        entry->_next->_prev = entry->_prev;
+    }
+    _count--;
+    _bytes.fetch_sub( entry->getBytes(), std::memory_order_relaxed );
+}
+
+// without a budget this is the only thing an update costs
+inline void CacheManager::charge( const size_t oldBytes, const size_t newBytes ) {
+    size_t total = _bytes.fetch_add( newBytes - oldBytes, std::memory_order_relaxed ) + newBytes - oldBytes;
+    size_t budget = getBudget();
+    if (budget != 0 && total > budget) {
+        enforce();
+    }
+}
+
+// a cache which was used since the hand passed it last time gets a second chance. only the caches of the calling
+// thread are evicted, the others are left to their own threads. two full turns without progress mean that
+// nothing else can be evicted right now
+inline void CacheManager::enforce() {
+    std::unique_lock<std::mutex> guard( _lock, std::try_to_lock );
+    if (!guard.owns_lock()) {
+        return; // somebody is already evicting, which might be this very thread through an evicted sequence
+    }
+    const auto self = std::this_thread::get_id();
+    size_t idle = 0;
+    while (getBytes() > getBudget() && _head != nullptr && idle < 2 * _count) {
+        if (_hand == nullptr) {
+            _hand = _head;
+        }
+        CacheEntry* entry = _hand;
+        _hand = entry->_next;
+        if (entry->_referenced.exchange( false, std::memory_order_relaxed ) || entry->_thread.load( std::memory_order_relaxed ) != self) {
+            idle++;
+            continue;
+        }
+        size_t freed = entry->evictOldest( getBytes() - getBudget() );
+        if (freed == 0) {
+            idle++;
+            continue;
+        }
+        idle = 0;
+        entry->_bytes.fetch_sub( freed, std::memory_order_relaxed );
+        _bytes.fetch_sub( freed, std::memory_order_relaxed );
+        _evictions.fetch_add( 1, std::memory_order_relaxed );
+        _evictedBytes.fetch_add( freed, std::memory_order_relaxed );
+    }
+}
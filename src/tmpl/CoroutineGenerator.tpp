@@ -0,0 +1,81 @@
+// copies start their own run of the body from the beginning, the same way copied generators start over.
+// the body is shared with the copies and only its pointer is moved, so a moved run keeps its captures
+
+template <typename T>
+CoroutineGenerator<T>::CoroutineGenerator( const std::function<Coroutine<T>()>& body )
+: _body( makeShared<std::function<Coroutine<T>()>>( body )), _coroutine( (*_body)() ), _isSuspended( false ) {}
+
+template <typename T>
+CoroutineGenerator<T>::CoroutineGenerator( const CoroutineGenerator<T>& other )
+: _body( other._body ), _coroutine( (*_body)() ), _isSuspended( false ) {}
+
+template <typename T>
+CoroutineGenerator<T>& CoroutineGenerator<T>::operator=( const CoroutineGenerator<T>& other ) {
+    if (this != &other) {
+        _coroutine = Coroutine<T>();
+        _body = other._body;
+        _coroutine = (*_body)();
+        _isSuspended = false;
+    }
+    return *this;
+}
+
+template <typename T>
+CoroutineGenerator<T>::CoroutineGenerator( CoroutineGenerator<T>&& other )
+: _body( std::move( other._body )), _coroutine( std::move( other._coroutine )), _isSuspended( other._isSuspended ) {
+    other._isSuspended = false;
+}
+
+template <typename T>
+CoroutineGenerator<T>& CoroutineGenerator<T>::operator=( CoroutineGenerator<T>&& other ) {
+    if (this != &other) {
+        _coroutine = std::move( other._coroutine );
+        _body = std::move( other._body );
+        _isSuspended = other._isSuspended;
+        other._isSuspended = false;
+    }
+    return *this;
+}
+
+template <typename T>
+T CoroutineGenerator<T>::getNext() {
+    LAZY_TRACE();
+    if (!hasNext()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    _isSuspended = false;
+    return _coroutine.getValue();
+}
+
+template <typename T>
+T CoroutineGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
+    if (!index.isFinite()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    LAZY_COUNT( replays, 1 );
+    auto replay = (*_body)();
+    for (size_t step = 0; step <= static_cast<size_t>( index ); step++) {
+        if (!replay.next()) {
+            throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+        }
+    }
+    return replay.getValue();
+}
+
+template <typename T>
+bool CoroutineGenerator<T>::hasNext() {
+    if (!_isSuspended) {
+        _isSuspended = _coroutine.next();
+    }
+    return _isSuspended;
+}
+
+template <typename T>
+Option<T> CoroutineGenerator<T>::tryGetNext() {
+    if (hasNext()) {
+        return Option<T>( getNext() );
+    } else {
+        return Option<T>();
+    }
+}
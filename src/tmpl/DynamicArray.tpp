@@ -297,6 +297,9 @@ size_t DynamicArray<T>::getCapacity() const {
 
 template <typename T>
 void DynamicArray<T>::map( const std::function<T(T&)>& func ) {
+    if (BatchKernels<T>::tryMap( _data, _size, func )) {
+        return;
+    }
     for (size_t index = 0; index < _size; index++) {
         _data[index] = func( _data[index] );
     }
@@ -304,10 +307,20 @@ void DynamicArray<T>::map( const std::function<T(T&)>& func ) {
 
 template <typename T>
 void DynamicArray<T>::where( const std::function<bool(T)>& func ) {
-    for ( size_t index = 0; index < _size; ) {
-        if ( !func((*this)[index]) ) { removeAt(index); } 
-        else { index++; }
+    size_t kept = _size;
+    if (!BatchKernels<T>::tryWhere( _data, kept, func )) {
+        // stable in-place compaction, removing elements one by one would be quadratic
+        kept = 0;
+        for (size_t index = 0; index < _size; index++) {
+            if (func( _data[index] )) {
+                if (kept != index) {
+                    _data[kept] = std::move( _data[index] );
+                }
+                kept++;
+            }
+        }
     }
+    shrink( _size - kept );
 }
 
 template <typename T>
@@ -315,6 +328,16 @@ bool DynamicArray<T>::isEmpty() const {
     return _size == 0;
 }
 
+template <typename T>
+T* DynamicArray<T>::getData() {
+    return _data;
+}
+
+template <typename T>
+const T* DynamicArray<T>::getData() const {
+    return _data;
+}
+
 template <typename T>
 DynamicArray<T>* DynamicArray<T>::appendImmutable( const T& value ) const {
     DynamicArray<T>* res = new DynamicArray<T>(*this);
@@ -366,7 +389,13 @@ DynamicArray<T>* DynamicArray<T>::concatImmutable( const DynamicArray<T>& other
 template <typename T>
 DynamicArray<T>* DynamicArray<T>::mapImmutable( const std::function<T(T)>& func ) const {
     auto res = new DynamicArray<T>(*this);
-    res->map(func);
+    if (BatchKernels<T>::tryMap( res->_data, res->_size, func )) {
+        return res;
+    }
+    // map() would look for a kernel once more, behind a wrapper it can't see through
+    for (size_t index = 0; index < res->_size; index++) {
+        res->_data[index] = func( res->_data[index] );
+    }
     return res;
 }
 
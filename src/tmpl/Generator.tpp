@@ -1,3 +1,49 @@
+#include <cstdlib>
+#include <cxxabi.h>
+#include <typeinfo>
+
+template <typename T>
+std::string IGenerator<T>::getName() const {
+    int status = 0;
+    char* demangled = abi::__cxa_demangle( typeid(*this).name(), nullptr, nullptr, &status );
+    std::string res = status == 0 ? demangled : typeid(*this).name();
+    std::free( demangled );
+    return res;
+}
+
+template <typename T>
+void IGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    (void)visitor;
+}
+
+template <typename T>
+double IGenerator<T>::getPullFactor() const {
+    return 1.0;
+}
+
+template <typename T>
+size_t IGenerator<T>::getStateBytes() const {
+    return 0;
+}
+
+template <typename T>
+void IGenerator<T>::saveState( SnapshotWriter& out ) const {
+    (void)out;
+    throw Exception( Exception::ErrorCode::UNSUPPORTED_SNAPSHOT );
+}
+
+template <typename T>
+void IGenerator<T>::restoreState( SnapshotReader& in ) {
+    (void)in;
+    throw Exception( Exception::ErrorCode::UNSUPPORTED_SNAPSHOT );
+}
+
+template <typename T>
+ScanStatus IGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    (void)budget;
+    return hasNext() ? ScanStatus::FOUND : ScanStatus::FINISHED;
+}
+
 template <typename T>
 FiniteGenerator<T>::FiniteGenerator() {
     _data = ArraySequence<T>();
@@ -51,12 +97,14 @@ FiniteGenerator<T>& FiniteGenerator<T>::operator=( FiniteGenerator<T>&& other )
 
 template <typename T>
 T FiniteGenerator<T>::getNext() {
+    LAZY_TRACE();
     if (!hasNext()) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
     return _data[static_cast<size_t>(_lastMaterialized++)];
 }
 
 template <typename T>
 T FiniteGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     return _data[static_cast<size_t>(index)];
 }
 
@@ -125,6 +173,7 @@ InfiniteGenerator<T>::InfiniteGenerator( const size_t arity
 
 template <typename T>
 T InfiniteGenerator<T>::getNext() {
+    LAZY_TRACE();
     auto next = _producingFunc( _window );
     _window.removeAt(0);
     _window.append(next);
@@ -134,10 +183,15 @@ T InfiniteGenerator<T>::getNext() {
 
 template <typename T>
 T InfiniteGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index < _lastMaterialized) {
+        LAZY_COUNT( dematerializedAccesses, 1 );
         throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
     }
     auto temp = _window;
+    if (index > _lastMaterialized + _arity - 1) {
+        LAZY_COUNT( replays, 1 );
+    }
     for (size_t i = _lastMaterialized + _arity - 1; i < index; i++) {
         auto next = _producingFunc( temp );
         temp.removeAt(0);
@@ -216,11 +270,11 @@ AppendGenerator<T>& AppendGenerator<T>::operator=( AppendGenerator<T>&& other )
 
 template <typename T>
 T AppendGenerator<T>::getNext() {
-    if ( !hasNext() ) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
-    if (_initial->canMemoiseNext()) {
-        return _initial->memoiseNext();
-    } else if (_added->canMemoiseNext()) {
-        return _added->memoiseNext();
+    LAZY_TRACE();
+    if (_initial.hasNext()) {
+        return _initial.next();
+    } else if (_added.hasNext()) {
+        return _added.next();
     } else {
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
@@ -228,6 +282,7 @@ T AppendGenerator<T>::getNext() {
 
 template <typename T>
 T AppendGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (_border.hasValue()) {
         if (index >= _border.get()) {
             return _added->get( index - _border.get() );
@@ -241,12 +296,18 @@ T AppendGenerator<T>::get( const Ordinal& index ) {
 
 template <typename T>
 bool AppendGenerator<T>::hasNext() {
-    return _initial->canMemoiseNext() || _added->canMemoiseNext();
+    return _initial.hasNext() || _added.hasNext();
+}
+
+template <typename T>
+ScanStatus AppendGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    ScanStatus status = _initial.scan( budget );
+    return status == ScanStatus::FINISHED ? _added.scan( budget ) : status;
 }
 
 template <typename T>
 Option<T> AppendGenerator<T>::tryGetNext() {
-    if (hasNext()) {
+    if (scan( Option<ScanBudget>() ) == ScanStatus::FOUND) {
         return Option<T>( getNext() );
     } else {
         return Option<T>();
@@ -316,12 +377,13 @@ PrependGenerator<T>& PrependGenerator<T>::operator=( PrependGenerator<T>&& other
 
 template <typename T>
 T PrependGenerator<T>::getNext() {
-    if ( !hasNext() ) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
-    _lastMaterialized++;
-    if (_added->canMemoiseNext()) {
-        return _added->memoiseNext();
-    } else if (_initial->canMemoiseNext()) {
-        return _initial->memoiseNext();
+    LAZY_TRACE();
+    if (_added.hasNext()) {
+        _lastMaterialized++;
+        return _added.next();
+    } else if (_initial.hasNext()) {
+        _lastMaterialized++;
+        return _initial.next();
     } else {
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
@@ -329,6 +391,7 @@ T PrependGenerator<T>::getNext() {
 
 template <typename T>
 T PrependGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (_border.hasValue()) {
         if (index >= _border.get()) {
             return _initial->get( index - _border.get() );
@@ -342,12 +405,18 @@ T PrependGenerator<T>::get( const Ordinal& index ) {
 
 template <typename T>
 bool PrependGenerator<T>::hasNext() {
-    return _added->canMemoiseNext() || _initial->canMemoiseNext();
+    return _added.hasNext() || _initial.hasNext();
+}
+
+template <typename T>
+ScanStatus PrependGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    ScanStatus status = _added.scan( budget );
+    return status == ScanStatus::FINISHED ? _initial.scan( budget ) : status;
 }
 
 template <typename T>
 Option<T> PrependGenerator<T>::tryGetNext() {
-    if (hasNext()) {
+    if (scan( Option<ScanBudget>() ) == ScanStatus::FOUND) {
         return Option<T>( getNext() );
     } else {
         return Option<T>();
@@ -424,14 +493,16 @@ InsertGenerator<T>& InsertGenerator<T>::operator=( InsertGenerator<T>&& other )
 
 template <typename T>
 T InsertGenerator<T>::getNext() {
-    if ( !hasNext() ) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
-    auto current = _lastMaterialized++;
+    LAZY_TRACE();
+    auto current = _lastMaterialized;
     if ((current <  _targetIndex || (_border.hasValue() && current >= _border.get())) 
-        && _initial->canMemoiseNext())  {
-        return _initial->memoiseNext();
+        && _initial.hasNext())  {
+        _lastMaterialized++;
+        return _initial.next();
     } else if ((current >= _targetIndex && _border.hasValue() && current < _border.get()) 
-                && _added->canMemoiseNext()) {
-        return _added->memoiseNext();
+                && _added.hasNext()) {
+        _lastMaterialized++;
+        return _added.next();
     } else {
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
@@ -439,6 +510,7 @@ T InsertGenerator<T>::getNext() {
 
 template <typename T>
 T InsertGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index < _targetIndex) { return (*_initial)[index]; } 
     if (_border.hasValue()) {
         auto border = _border.get();
@@ -458,7 +530,7 @@ T InsertGenerator<T>::get( const Ordinal& index ) {
 
 template <typename T>
 bool InsertGenerator<T>::hasNext() {
-    return _initial->canMemoiseNext() || _added->canMemoiseNext();
+    return _initial.hasNext() || _added.hasNext();
 }
 
 template <typename T>
@@ -532,22 +604,23 @@ SkipGenerator<T>& SkipGenerator<T>::operator=( SkipGenerator<T>&& other ) {
 
 template <typename T>
 T SkipGenerator<T>::getNext() {
+    LAZY_TRACE();
     if (!hasNext()) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
     auto current = _lastMaterialized++;
     if (current < _from) {
-        return _parent->memoiseNext();
+        return _parent.next();
     } else if (current == _from) {
         if (_to.isFinite()) {
             for (size_t i = 0; i < _to - _from; i++) {
-                _parent->memoiseNext();
+                _parent.next();
             }
-            return _parent->memoiseNext();
+            return _parent.next();
         } else {
             return _parent->get( _to );
         }
     } else {
         if (_to.isFinite()) {
-            return _parent->memoiseNext();
+            return _parent.next();
         } else {
             return _parent->get( _to + (current - _from) );
         }
@@ -556,6 +629,7 @@ T SkipGenerator<T>::getNext() {
 
 template <typename T>
 T SkipGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index < _from) {
         return _parent->get(index);
     } else {
@@ -565,7 +639,7 @@ T SkipGenerator<T>::get( const Ordinal& index ) {
 
 template <typename T>
 bool SkipGenerator<T>::hasNext() {
-    return _parent->canMemoiseNext();
+    return _parent.hasNext();
 }
 
 template <typename T>
@@ -633,17 +707,18 @@ SubSequenceGenerator<T>& SubSequenceGenerator<T>::operator=( SubSequenceGenerato
 
 template <typename T>
 T SubSequenceGenerator<T>::getNext() {
+    LAZY_TRACE();
     if (!hasNext()) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
     auto current = _lastMaterialized++;
     if (_from.isFinite()) {
         if ( current == 0 ) {
             while ( current < _from ) {
-                _parent->memoiseNext();
+                _parent.next();
                 current++;
             }
-            return _parent->memoiseNext();
+            return _parent.next();
         } else if ( current < _to - _from ) {
-            return _parent->memoiseNext();
+            return _parent.next();
         } else {
             throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
         }
@@ -654,11 +729,11 @@ T SubSequenceGenerator<T>::getNext() {
             throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
         }
     }
-    _lastMaterialized++;
 }
 
 template <typename T>
 T SubSequenceGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index >= _from || index < _to) {
         return _parent->get(_from + index);
     } else {
@@ -727,10 +802,11 @@ ConcatGenerator<T>& ConcatGenerator<T>::operator=( ConcatGenerator<T>&& other )
 
 template <typename T>
 T ConcatGenerator<T>::getNext() {
-    if (_first->canMemoiseNext()) {
-        return _first->memoiseNext();
-    } else if (_second->canMemoiseNext()) {
-        return _second->memoiseNext();
+    LAZY_TRACE();
+    if (_first.hasNext()) {
+        return _first.next();
+    } else if (_second.hasNext()) {
+        return _second.next();
     } else {
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
@@ -738,6 +814,7 @@ T ConcatGenerator<T>::getNext() {
 
 template <typename T>
 T ConcatGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (_border.hasValue()) {
         if (index < _border.get()) {
             return _first->get(index);
@@ -751,12 +828,18 @@ T ConcatGenerator<T>::get( const Ordinal& index ) {
 
 template <typename T>
 bool ConcatGenerator<T>::hasNext() {
-    return _first->canMemoiseNext() || _second->canMemoiseNext();
+    return _first.hasNext() || _second.hasNext();
+}
+
+template <typename T>
+ScanStatus ConcatGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    ScanStatus status = _first.scan( budget );
+    return status == ScanStatus::FINISHED ? _second.scan( budget ) : status;
 }
 
 template <typename T>
 Option<T> ConcatGenerator<T>::tryGetNext() {
-    if (hasNext()) {
+    if (scan( Option<ScanBudget>() ) == ScanStatus::FOUND) {
         return Option<T>( getNext());
     } else {
         return Option<T>();
@@ -801,22 +884,29 @@ MapGenerator<TIn, TOut>& MapGenerator<TIn, TOut>::operator=( MapGenerator<TIn, T
 
 template <typename TIn, typename TOut>
 TOut MapGenerator<TIn, TOut>::getNext() {
-    return _func( _parent->memoiseNext() );
+    LAZY_TRACE();
+    return _func( _parent.next() );
 }
 
 template <typename TIn, typename TOut>
 TOut MapGenerator<TIn, TOut>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     return _func( _parent->get( index ) );
 }
 
 template <typename TIn, typename TOut>
 bool MapGenerator<TIn, TOut>::hasNext() {
-    return _parent->canMemoiseNext();
+    return _parent.hasNext();
+}
+
+template <typename TIn, typename TOut>
+ScanStatus MapGenerator<TIn, TOut>::scan( const Option<ScanBudget>& budget ) {
+    return _parent.scan( budget );
 }
 
 template <typename TIn, typename TOut>
 Option<TOut> MapGenerator<TIn, TOut>::tryGetNext() {
-    if (hasNext()) {
+    if (scan( Option<ScanBudget>() ) == ScanStatus::FOUND) {
         return Option<TOut>( getNext() );
     } else {
         return Option<TOut>();
@@ -824,18 +914,24 @@ Option<TOut> MapGenerator<TIn, TOut>::tryGetNext() {
 }
 
 template <typename T>
-WhereGenerator<T>::WhereGenerator( const std::function<bool(T)>& func, SharedPtr<LazySequence<T>> parent )
+WhereGenerator<T>::WhereGenerator( const std::function<bool(T)>& func, SharedPtr<LazySequence<T>> parent, const ScanBudget& budget )
 : _predicate( func )
 , _parent( parent )
 , _memoized( Option<T>() )
-, _isFinished( false ) {}
+, _positions()
+, _dropped( 0 )
+, _emitted( 0 )
+, _budget( budget ) {}
 
 template <typename T>
 WhereGenerator<T>::WhereGenerator( const WhereGenerator<T>& other )
 : _predicate( other._predicate )
 , _parent( other._parent )
 , _memoized( other._memoized ) 
-, _isFinished( other._isFinished ){}
+, _positions( other._positions )
+, _dropped( other._dropped )
+, _emitted( other._emitted )
+, _budget( other._budget ) {}
 
 template <typename T>
 WhereGenerator<T>& WhereGenerator<T>::operator=( const WhereGenerator<T>& other ) {
@@ -843,7 +939,10 @@ WhereGenerator<T>& WhereGenerator<T>::operator=( const WhereGenerator<T>& other
         _predicate  = other._predicate;
         _parent     = other._parent;
         _memoized   = other._memoized;
-        _isFinished = other._isFinished;
+        _positions  = other._positions;
+        _dropped    = other._dropped;
+        _emitted    = other._emitted;
+        _budget     = other._budget;
     } 
     return *this;
 }
@@ -853,7 +952,10 @@ WhereGenerator<T>::WhereGenerator( WhereGenerator<T>&& other )
 : _predicate( std::move( other._predicate ))
 , _parent( std::move( other._parent ))
 , _memoized( std::move( other._memoized )) 
-, _isFinished( other._isFinished ) { other._isFinished = false; }
+, _positions( std::move( other._positions ))
+, _dropped( other._dropped )
+, _emitted( other._emitted )
+, _budget( other._budget ) { other._dropped = 0; other._emitted = 0; }
 
 template <typename T>
 WhereGenerator<T>& WhereGenerator<T>::operator=( WhereGenerator<T>&& other ) {
@@ -861,60 +963,346 @@ WhereGenerator<T>& WhereGenerator<T>::operator=( WhereGenerator<T>&& other ) {
         _predicate  = std::move(other._predicate);
         _parent     = std::move(other._parent);
         _memoized   = std::move(other._memoized);
-        _isFinished = other._isFinished;
+        _positions  = std::move(other._positions);
+        _dropped    = other._dropped;
+        _emitted    = other._emitted;
+        _budget     = other._budget;
 
-        other._isFinished = 0;
+        other._dropped = 0;
+        other._emitted = 0;
     } 
     return *this;
 }
 
 template <typename T>
 T WhereGenerator<T>::getNext() {
-    if (!_isFinished) { 
-        if (!hasNext()) { 
-            throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
-        }
-        auto res = _memoized.get();
-        _memoized = Option<T>();
-        return res;
-    } else {
+    LAZY_TRACE();
+    if (!hasNext()) { 
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
+    return get( _emitted++ );
 }
 
+// accepted elements are addressed through the positional index, so any index that was already scanned and not trimmed
+// costs a single lookup in the parent, and indices beyond the scanned frontier continue the scan from where it stopped
 template <typename T>
 T WhereGenerator<T>::get( const Ordinal& index ) {
-    if (index.isFinite()) {}
-    throw Exception( Exception::ErrorCode::UNKNOWN_ORDINALITY );
+    LAZY_TRACE();
+    if (index.isTransfinite()) {
+        throw Exception( Exception::ErrorCode::UNKNOWN_ORDINALITY );
+    }
+    auto target = static_cast<size_t>(index);
+    if (target < _dropped) {
+        throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
+    }
+    ensureScanned( target + 1 );
+    if (target == getScannedCount() - 1 && _memoized.hasValue()) {
+        return _memoized.get();
+    }
+    return _parent->get( _positions[target - _dropped] );
 }
 
-// #include <iostream>
 template <typename T>
 bool WhereGenerator<T>::hasNext() {
-    if (!_parent->canMemoiseNext() || _isFinished) {
-        return false;
-    } else {
-        auto allowance = 0;
-        while (_parent->canMemoiseNext()) {
-            auto candidate = _parent->memoiseNext();
-            if (_predicate(candidate)) {
-                _memoized = candidate;
-                return true;
-            }
-            if (++allowance > 10'000) {
-                _isFinished = true;
-                break;
-            }
-        }
+    switch (scan( Option<ScanBudget>() )) {
+    case ScanStatus::FOUND:
+        return true;
+    case ScanStatus::FINISHED:
         return false;
+    default:
+        throw Exception( Exception::ErrorCode::SCAN_BUDGET_EXHAUSTED );
     }
 }
 
 template <typename T>
 Option<T> WhereGenerator<T>::tryGetNext() {
-    if (hasNext()) {
+    if (scan( Option<ScanBudget>() ) == ScanStatus::FOUND) {
         return Option<T>( getNext());
     } else {
         return Option<T>();
     }
-}
\ No newline at end of file
+}
+
+template <typename T>
+ScanStatus WhereGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    if (_emitted < getScannedCount()) {
+        return ScanStatus::FOUND;
+    }
+    ScanBudget::Meter meter( budget.hasValue() ? budget.get() : _budget );
+    return scanNext( meter, budget );
+}
+
+template <typename T>
+const ScanBudget& WhereGenerator<T>::getBudget() const {
+    return _budget;
+}
+
+template <typename T>
+void WhereGenerator<T>::setBudget( const ScanBudget& budget ) {
+    _budget = budget;
+}
+
+// rejected candidates are never revisited and the parent keeps its own cursor,
+// so a scan interrupted by the budget, this one's or one up the pipeline, resumes exactly where it stopped
+template <typename T>
+ScanStatus WhereGenerator<T>::scanNext( ScanBudget::Meter& meter, const Option<ScanBudget>& budget ) {
+    ScanStatus status;
+    while ((status = _parent.scan( budget )) == ScanStatus::FOUND) {
+        auto candidate = _parent.next();
+        if (_predicate(candidate)) {
+            _positions.append( _parent.getPosition() - 1 );
+            trimPositions();
+            _memoized = candidate;
+            return ScanStatus::FOUND;
+        }
+        LAZY_COUNT( whereRejections, 1 );
+        if (!meter.step()) {
+            return ScanStatus::BUDGET_EXHAUSTED;
+        }
+    }
+    return status;
+}
+
+template <typename T>
+void WhereGenerator<T>::ensureScanned( const size_t count ) {
+    ScanBudget::Meter meter( _budget );
+    while (getScannedCount() < count) {
+        switch (scanNext( meter, Option<ScanBudget>() )) {
+        case ScanStatus::FOUND:
+            break;
+        case ScanStatus::FINISHED:
+            throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+        default:
+            throw Exception( Exception::ErrorCode::SCAN_BUDGET_EXHAUSTED );
+        }
+    }
+}
+
+// half of the positions go at once, so trimming costs O(1) per accepted element. the ones not emitted yet stay,
+// getNext() still needs them
+template <typename T>
+void WhereGenerator<T>::trimPositions() {
+    if (_positions.getSize() <= POSITIONS_MAX_SIZE) {
+        return;
+    }
+    size_t count = _positions.getSize() - POSITIONS_MAX_SIZE / 2;
+    count = count < _emitted - _dropped ? count : _emitted - _dropped;
+    if (count == 0) {
+        return;
+    }
+    Sequence<size_t>* rest = _positions.getSubSequence( static_cast<int>( count ), static_cast<int>( _positions.getSize() ));
+    _positions = std::move( *static_cast<ArraySequence<size_t>*>( rest ));
+    delete rest;
+    _dropped += count;
+}
+
+template <typename T>
+size_t WhereGenerator<T>::getScannedCount() const {
+    return _dropped + _positions.getSize();
+}
+
+template <typename T>
+void AppendGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _initial.getSequence() );
+    visitor.visit( _added.getSequence() );
+}
+
+template <typename T>
+void PrependGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _added.getSequence() );
+    visitor.visit( _initial.getSequence() );
+}
+
+template <typename T>
+void InsertGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _initial.getSequence() );
+    visitor.visit( _added.getSequence() );
+}
+
+template <typename T>
+void SkipGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _parent.getSequence() );
+}
+
+template <typename T>
+void SubSequenceGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _parent.getSequence() );
+}
+
+template <typename T>
+void ConcatGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _first.getSequence() );
+    visitor.visit( _second.getSequence() );
+}
+
+template <typename TIn, typename TOut>
+void MapGenerator<TIn, TOut>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _parent.getSequence() );
+}
+
+template <typename T>
+void WhereGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _parent.getSequence() );
+}
+
+// the last accepted element was found at its parent index + 1 pulls of the parent
+template <typename T>
+double WhereGenerator<T>::getPullFactor() const {
+    if (_positions.isEmpty()) {
+        return 1.0;
+    }
+    return static_cast<double>( _positions[_positions.getSize() - 1] + 1 ) / static_cast<double>( getScannedCount() );
+}
+
+template <typename T>
+size_t FiniteGenerator<T>::getStateBytes() const {
+    return _data.getSize() * sizeof(T);
+}
+
+template <typename T>
+size_t InfiniteGenerator<T>::getStateBytes() const {
+    return _window.getSize() * sizeof(T);
+}
+
+template <typename T>
+size_t WhereGenerator<T>::getStateBytes() const {
+    return _positions.getSize() * sizeof(size_t) + (_memoized.hasValue() ? sizeof(T) : 0);
+}
+
+// the data itself is part of the sequence being restored, only its size is checked
+template <typename T>
+void FiniteGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _data.getSize() );
+    out.write( _lastMaterialized );
+}
+
+template <typename T>
+void FiniteGenerator<T>::restoreState( SnapshotReader& in ) {
+    in.expect( _data.getSize() );
+    _lastMaterialized = in.read<size_t>();
+}
+
+template <typename T>
+void InfiniteGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _arity );
+    out.write( _lastMaterialized );
+    out.write( _window );
+}
+
+template <typename T>
+void InfiniteGenerator<T>::restoreState( SnapshotReader& in ) {
+    in.expect( _arity );
+    size_t lastMaterialized = in.read<size_t>();
+    auto window = in.read<ArraySequence<T>>();
+    if (window.getSize() != _arity) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+    _lastMaterialized = lastMaterialized;
+    _window = std::move( window );
+}
+
+template <typename T>
+void AppendGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+    _initial.saveState( out );
+    _added.saveState( out );
+}
+
+template <typename T>
+void AppendGenerator<T>::restoreState( SnapshotReader& in ) {
+    _lastMaterialized = in.read<size_t>();
+    _initial.restoreState( in );
+    _added.restoreState( in );
+}
+
+template <typename T>
+void PrependGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+    _added.saveState( out );
+    _initial.saveState( out );
+}
+
+template <typename T>
+void PrependGenerator<T>::restoreState( SnapshotReader& in ) {
+    _lastMaterialized = in.read<size_t>();
+    _added.restoreState( in );
+    _initial.restoreState( in );
+}
+
+template <typename T>
+void InsertGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+    _initial.saveState( out );
+    _added.saveState( out );
+}
+
+template <typename T>
+void InsertGenerator<T>::restoreState( SnapshotReader& in ) {
+    _lastMaterialized = in.read<size_t>();
+    _initial.restoreState( in );
+    _added.restoreState( in );
+}
+
+template <typename T>
+void SkipGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+    _parent.saveState( out );
+}
+
+template <typename T>
+void SkipGenerator<T>::restoreState( SnapshotReader& in ) {
+    _lastMaterialized = in.read<size_t>();
+    _parent.restoreState( in );
+}
+
+template <typename T>
+void SubSequenceGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+    _parent.saveState( out );
+}
+
+template <typename T>
+void SubSequenceGenerator<T>::restoreState( SnapshotReader& in ) {
+    _lastMaterialized = in.read<size_t>();
+    _parent.restoreState( in );
+}
+
+template <typename T>
+void ConcatGenerator<T>::saveState( SnapshotWriter& out ) const {
+    _first.saveState( out );
+    _second.saveState( out );
+}
+
+template <typename T>
+void ConcatGenerator<T>::restoreState( SnapshotReader& in ) {
+    _first.restoreState( in );
+    _second.restoreState( in );
+}
+
+template <typename TIn, typename TOut>
+void MapGenerator<TIn, TOut>::saveState( SnapshotWriter& out ) const {
+    _parent.saveState( out );
+}
+
+template <typename TIn, typename TOut>
+void MapGenerator<TIn, TOut>::restoreState( SnapshotReader& in ) {
+    _parent.restoreState( in );
+}
+
+template <typename T>
+void WhereGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _emitted );
+    out.write( _dropped );
+    out.write( _positions );
+    out.write( _memoized );
+    _parent.saveState( out );
+}
+
+template <typename T>
+void WhereGenerator<T>::restoreState( SnapshotReader& in ) {
+    _emitted   = in.read<size_t>();
+    _dropped   = in.read<size_t>();
+    _positions = in.read<ArraySequence<size_t>>();
+    _memoized  = in.read<Option<T>>();
+    _parent.restoreState( in );
+}
@@ -1,44 +1,66 @@
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 HeightMapGenerator::HeightMapGenerator() 
-: _size(16), _lastMaterialized(0), _prevEdge() {
-    _rng = std::mt19937( std::random_device{}() );
-    _dist = std::uniform_real_distribution<float>( -1.0f, 1.0f );
-    
+: _size(16), _lastMaterialized(0), _prevEdge()
+, _rng( CounterRng::randomSeed() ), _scale( CounterRng::symmetricScale( 1.0f ))
+, _checkpointInterval(64), _checkpoints(), _kernel( ChunkKernel::WAVEFRONT ) {
     for (size_t i = 0; i < _size; i++) {
         _prevEdge.append(1.0f);
     }
+    _checkpoints.append( _prevEdge );
 }
     
-HeightMapGenerator::HeightMapGenerator( const column& seed, const size_t size, const float amp )
-: _size( size ),  _lastMaterialized(0), _prevEdge( seed ) {
-    _rng = std::mt19937( std::random_device{}() );
-    _dist = std::uniform_real_distribution<float>( -amp, amp ); 
+HeightMapGenerator::HeightMapGenerator( const column& seed, const size_t size, const float amp, const uint64_t rngSeed )
+: _size( size ),  _lastMaterialized(0), _prevEdge( seed )
+, _rng( rngSeed ), _scale( CounterRng::symmetricScale( amp ))
+, _checkpointInterval(64), _checkpoints(), _kernel( ChunkKernel::WAVEFRONT ) {
+    if (seed.getSize() != _size) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    _checkpoints.append( _prevEdge );
 }
 
-HeightMapGenerator::HeightMapGenerator( const float begin, const size_t size, const float amp )
-: _size( size ), _lastMaterialized(0), _prevEdge() {
-    _rng = std::mt19937( std::random_device{}() );
-    _dist = std::uniform_real_distribution<float>( -amp, amp ); 
-
+HeightMapGenerator::HeightMapGenerator( const float begin, const size_t size, const float amp, const uint64_t rngSeed )
+: _size( size ), _lastMaterialized(0), _prevEdge()
+, _rng( rngSeed ), _scale( CounterRng::symmetricScale( amp ))
+, _checkpointInterval(64), _checkpoints(), _kernel( ChunkKernel::WAVEFRONT ) {
     for (size_t i = 0; i < _size; i++) {
         _prevEdge.append(begin);
     }
+    _checkpoints.append( _prevEdge );
 }
 
 chunk HeightMapGenerator::getNext() {
+    LAZY_TRACE();
     if (!hasNext()) { 
         throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
     }
-    auto res = nextChunk();
-    _prevEdge = res[_size - 1];
+    chunk res( _size );
+    fill( res.getData(), _prevEdge.getData(), _lastMaterialized );
+    storeEdge( res.getData(), _prevEdge.getData() );
+    passChunk( _lastMaterialized++, _prevEdge.getData() );
     return res;
 }
 
 chunk HeightMapGenerator::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index.isTransfinite()) {
         throw Exception( Exception::ErrorCode::INCONSISTENT_CHUNK_ACCESS );
+    }
+    auto pos = static_cast<size_t>( index );
+    chunk res( _size );
+    if (pos == _lastMaterialized) {
+        fill( res.getData(), _prevEdge.getData(), pos );
     } else {
-        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+        auto edge = edgeBefore( pos );
+        fill( res.getData(), edge.getData(), pos );
     }
+    return res;
 }
 
 bool HeightMapGenerator::hasNext() {
@@ -53,25 +75,302 @@ Option<chunk> HeightMapGenerator::tryGetNext() {
     }
 }
 
-// keep in mind that structure-wise chunk is not a usual 2d-array:
-// when accessing elements of chunk, you firstly need to access needed column and then row.
-// its done to assign the _prevEdge as the last column of the newly-generated chunk to increase readability.
-// tl;dr - chunk is a transponed matrix
-chunk HeightMapGenerator::nextChunk() {
-    chunk res;
-    for (size_t col = 0; col < _size; col++) {
-        column c;
-        for (size_t row = 0; row < _size; row++) {
-            float adjLeft, adjUpper;
-            if (col == 0) { adjLeft =  _prevEdge[row]; } 
-            else          { adjLeft = res[col-1][row]; }
+inline size_t HeightMapGenerator::getStateBytes() const {
+    return (_checkpoints.getSize() + 1) * _size * sizeof(float);
+}
+
+// chunks only depend on the seed and the edges, so the seed is all of the rng state
+inline void HeightMapGenerator::saveState( SnapshotWriter& out ) const {
+    out.write( _size );
+    out.write( _lastMaterialized );
+    out.write( _prevEdge );
+    out.write( _rng.getSeed() );
+    out.write( _scale );
+    out.write( _checkpointInterval );
+    out.write( _checkpoints );
+    out.write( _kernel );
+}
+
+inline void HeightMapGenerator::restoreState( SnapshotReader& in ) {
+    size_t size = in.read<size_t>();
+    size_t lastMaterialized = in.read<size_t>();
+    column prevEdge = in.read<column>();
+    uint64_t seed = in.read<uint64_t>();
+    float scale = in.read<float>();
+    size_t checkpointInterval = in.read<size_t>();
+    ArraySequence<column> checkpoints = in.read<ArraySequence<column>>();
+    ChunkKernel kernel = in.read<ChunkKernel>();
+    if (prevEdge.getSize() != size || checkpointInterval == 0 || checkpoints.isEmpty()) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+    _size = size;
+    _lastMaterialized = lastMaterialized;
+    _prevEdge = std::move( prevEdge );
+    _rng = CounterRng( seed );
+    _scale = scale;
+    _checkpointInterval = checkpointInterval;
+    _checkpoints = std::move( checkpoints );
+    _kernel = kernel;
+}
+
+inline void SnapshotCodec<chunk>::write( SnapshotWriter& out, const chunk& value ) {
+    out.write( value.getSize() );
+    out.writeBytes( value.getData(), value.getBytes() );
+}
+
+inline chunk SnapshotCodec<chunk>::read( SnapshotReader& in ) {
+    size_t size = in.read<size_t>();
+    in.expectRemaining( size, sizeof(float) );
+    in.expectRemaining( size, size * sizeof(float) );
+    chunk res( size );
+    in.readBytes( res.getData(), res.getBytes() );
+    return res;
+}
+
+template <size_t N>
+Tile<N> HeightMapGenerator::nextTile() {
+    if (_size != N) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    Tile<N> res;
+    fillTile<N>( res.getData(), _prevEdge.getData(), _lastMaterialized );
+    storeEdge( res.getData(), _prevEdge.getData() );
+    passChunk( _lastMaterialized++, _prevEdge.getData() );
+    return res;
+}
+
+ArraySequence<chunk> HeightMapGenerator::getRange( const size_t first, const size_t count, const size_t threads ) {
+    ArraySequence<chunk> res;
+    if (count == 0) {
+        return res;
+    }
+    for (size_t index = 0; index < count; index++) {
+        res.append( chunk() );
+    }
+    // checkpoints themselves can only be found sequentially, the segments after them are independent
+    const size_t last = first + count - 1;
+    edgeBefore( last / _checkpointInterval * _checkpointInterval );
 
-            if (row == 0) { adjUpper = adjLeft; }
-            else          { adjUpper = c[row-1];}
+    const size_t firstSegment = first / _checkpointInterval;
+    const size_t segments = last / _checkpointInterval - firstSegment + 1;
+    std::atomic<size_t> nextSegment(0);
+    chunk* out = res.getData();
+    std::exception_ptr error;
+    std::mutex errorLock;
 
-            c.append( (adjLeft + adjUpper) * 0.5f + _dist( _rng ) );
+    // the first exception stops the other workers from taking new segments and is rethrown once all of them are joined
+    auto worker = [&]() {
+        try {
+            chunk scratch( _size );
+            for (size_t segment = nextSegment++; segment < segments; segment = nextSegment++) {
+                size_t begin = (firstSegment + segment) * _checkpointInterval;
+                size_t end = begin + _checkpointInterval - 1 < last ? begin + _checkpointInterval - 1 : last;
+                column edge = _checkpoints[firstSegment + segment];
+                for (size_t index = begin; index <= end; index++) {
+                    if (index >= first) {
+                        out[index - first] = chunk( _size );
+                        fill( out[index - first].getData(), edge.getData(), index );
+                        storeEdge( out[index - first].getData(), edge.getData() );
+                    } else {
+                        fill( scratch.getData(), edge.getData(), index );
+                        storeEdge( scratch.getData(), edge.getData() );
+                    }
+                }
+            }
+        } catch ( ... ) {
+            std::lock_guard<std::mutex> guard( errorLock );
+            if (!error) {
+                error = std::current_exception();
+            }
+            nextSegment = segments;
         }
-        res.append( c );
+    };
+
+    size_t workers = threads ? threads : std::thread::hardware_concurrency();
+    workers = workers == 0 ? 1 : (workers > segments ? segments : workers);
+    {
+        std::vector<std::jthread> pool; // joined on the way out, a failed thread start included
+        pool.reserve( workers - 1 );
+        for (size_t index = 1; index < workers; index++) {
+            pool.emplace_back( worker );
+        }
+        worker();
+    }
+    if (error) {
+        std::rethrow_exception( error );
     }
     return res;
-}
\ No newline at end of file
+}
+
+void HeightMapGenerator::setCheckpointInterval( const size_t interval ) {
+    if (interval == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    column initial = _checkpoints[0];
+    _checkpoints.clear();
+    _checkpoints.append( initial );
+    _checkpointInterval = interval;
+}
+
+void HeightMapGenerator::fill( float* cells, const float* edge, const size_t index ) const {
+    // diagonals of small chunks are too short to fill the vectors, unrolled rows are faster there
+    if (_kernel == ChunkKernel::WAVEFRONT && _size >= WAVEFRONT_MIN_SIZE && BatchKernels<float>::getBestIsa() == KernelIsa::AVX2) {
+        fillWavefront( cells, edge, index );
+        return;
+    }
+    switch (_size) {
+    case 16:
+        fillTile<16>( cells, edge, index );
+        break;
+    case 32:
+        fillTile<32>( cells, edge, index );
+        break;
+    default:
+        fillTile<0>( cells, edge, index );
+        break;
+    }
+}
+
+// chunk is stored row-major, so the left neighbour is the previous cell of the same row
+// and the upper one is a full row behind. the first column continues the last column of the previous chunk.
+// N != 0 lets the compiler unroll the row loop for the common sizes
+template <size_t N>
+void HeightMapGenerator::fillTile( float* cells, const float* edge, const size_t index ) const {
+    const size_t size = N ? N : _size;
+    const uint32_t key = _rng.streamKey( index );
+    for (size_t row = 0; row < size; row++) {
+        float* curr = cells + row * size;
+        const float* upper = row == 0 ? nullptr : curr - size;
+        float adjLeft = edge[row];
+        for (size_t col = 0; col < size; col++) {
+            float adjUpper = upper ? upper[col] : adjLeft;
+            auto noise = CounterRng::symmetric( CounterRng::at( key, static_cast<uint32_t>( row * size + col )), _scale );
+            adjLeft = (adjLeft + adjUpper) * 0.5f + noise;
+            curr[col] = adjLeft;
+        }
+    }
+}
+
+#ifdef BATCH_KERNELS_X86
+static const size_t WAVEFRONT_BAND = 32; // rows of a band, keeps the strided scatter of diagonals inside L1
+
+// cells of one anti-diagonal depend only on the previous one, so a diagonal is computed 8 rows at a time.
+// chunk is processed in bands of rows, the upper neighbours of the first band row are the last row of the previous band.
+// prev and curr hold a diagonal indexed by band row + 1: slot 0 stands for the row above the band
+// and the slot past the last row of a growing diagonal stands for the left edge.
+// lanes past the end of a diagonal compute garbage which is never scattered nor read back.
+// diagonals are scattered into skew, where band row k keeps column c at k + c: its stride is padded,
+// since scattering straight into the chunk with a stride of a page size makes every lane hit the same cache set
+__attribute__((target("avx2")))
+inline void heightMapWavefrontAvx2( float* cells, const float* edge, const size_t size, const uint32_t key, const float scale
+                                  , float* prev, float* curr, float* skew, const size_t skewStride ) {
+    const __m256 half = _mm256_set1_ps( 0.5f );
+    const __m256 noiseScale = _mm256_set1_ps( scale );
+    const __m256i bias = _mm256_set1_epi32( 0x800000 );
+    const __m256i laneStep = _mm256_mullo_epi32( _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 ), _mm256_set1_epi32( static_cast<int32_t>( size - 1 )));
+    const __m256i golden = _mm256_set1_epi32( static_cast<int32_t>( 0x9e3779b9u ));
+    const __m256i keys = _mm256_set1_epi32( static_cast<int32_t>( key ));
+    const __m256i mul1 = _mm256_set1_epi32( 0x7feb352d );
+    const __m256i mul2 = _mm256_set1_epi32( static_cast<int32_t>( 0x846ca68bu ));
+    alignas(32) float lanes[8];
+
+    for (size_t bandBegin = 0; bandBegin < size; bandBegin += WAVEFRONT_BAND) {
+        const size_t band = size - bandBegin < WAVEFRONT_BAND ? size - bandBegin : WAVEFRONT_BAND;
+        const float* upperRow = bandBegin == 0 ? nullptr : cells + (bandBegin - 1) * size;
+
+        for (size_t diag = 0; diag < band + size - 1; diag++) {
+            size_t rowLo = diag < size ? 0 : diag - size + 1;
+            size_t rowHi = diag < band ? diag : band - 1;
+            if (diag < band) {
+                prev[diag + 1] = edge[bandBegin + diag];
+            }
+            if (diag < size) {
+                // the first row of the chunk has no upper neighbour and uses the left one twice
+                prev[0] = upperRow ? upperRow[diag] : prev[1];
+            }
+            for (size_t row = rowLo; row <= rowHi; row += 8) {
+                __m256 left  = _mm256_loadu_ps( prev + row + 1 );
+                __m256 upper = _mm256_loadu_ps( prev + row );
+
+                // cell (bandBegin + row + lane, diag - row - lane) has the counter
+                // (bandBegin + row) * size + diag - row + lane * (size - 1), same offset as in cells
+                size_t offset = (bandBegin + row) * size + diag - row;
+                __m256i counter = _mm256_add_epi32( _mm256_set1_epi32( static_cast<int32_t>( offset )), laneStep );
+                __m256i bits = _mm256_add_epi32( keys, _mm256_mullo_epi32( counter, golden ));
+                bits = _mm256_xor_si256( bits, _mm256_srli_epi32( bits, 16 ));
+                bits = _mm256_mullo_epi32( bits, mul1 );
+                bits = _mm256_xor_si256( bits, _mm256_srli_epi32( bits, 15 ));
+                bits = _mm256_mullo_epi32( bits, mul2 );
+                bits = _mm256_xor_si256( bits, _mm256_srli_epi32( bits, 16 ));
+                __m256 noise = _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_sub_epi32( _mm256_srli_epi32( bits, 8 ), bias )), noiseScale );
+
+                __m256 value = _mm256_add_ps( _mm256_mul_ps( _mm256_add_ps( left, upper ), half ), noise );
+                _mm256_storeu_ps( curr + row + 1, value );
+
+                _mm256_store_ps( lanes, value );
+                size_t count = rowHi - row + 1 < 8 ? rowHi - row + 1 : 8;
+                float* out = skew + row * skewStride + diag;
+                for (size_t lane = 0; lane < count; lane++) {
+                    out[lane * skewStride] = lanes[lane];
+                }
+            }
+            float* swap = prev;
+            prev = curr;
+            curr = swap;
+        }
+        for (size_t row = 0; row < band; row++) {
+            std::memcpy( cells + (bandBegin + row) * size, skew + row * skewStride + row, size * sizeof(float) );
+        }
+    }
+}
+#endif // BATCH_KERNELS_X86
+
+void HeightMapGenerator::fillWavefront( float* cells, const float* edge, const size_t index ) const {
+#ifdef BATCH_KERNELS_X86
+    // two diagonals of a band with the extra slot in front and a vector of padding behind, then the skewed band.
+    // the buffer is kept per thread and only grows, getRange() fills chunks of one generator from several threads
+    const size_t stride = WAVEFRONT_BAND + 9;
+    const size_t skewStride = _size + WAVEFRONT_BAND + 16;
+    const size_t slots = 2 * stride + WAVEFRONT_BAND * skewStride;
+    thread_local DynamicArray<float> scratch;
+    while (scratch.getSize() < slots) {
+        scratch.append( 0.0f );
+    }
+    float* diagonals = scratch.getData();
+    heightMapWavefrontAvx2( cells, edge, _size, _rng.streamKey( index ), _scale
+                          , diagonals, diagonals + stride, diagonals + 2 * stride, skewStride );
+#else
+    fillTile<0>( cells, edge, index );
+#endif
+}
+
+void HeightMapGenerator::storeEdge( const float* cells, float* edge ) const {
+    for (size_t row = 0; row < _size; row++) {
+        edge[row] = cells[row * _size + _size - 1];
+    }
+}
+
+column HeightMapGenerator::edgeBefore( const size_t index ) {
+    size_t checkpoint = index / _checkpointInterval;
+    if (checkpoint >= _checkpoints.getSize()) {
+        checkpoint = _checkpoints.getSize() - 1;
+    }
+    column edge = _checkpoints[checkpoint];
+    chunk scratch( _size );
+    for (size_t pos = checkpoint * _checkpointInterval; pos < index; pos++) {
+        fill( scratch.getData(), edge.getData(), pos );
+        storeEdge( scratch.getData(), edge.getData() );
+        passChunk( pos, edge.getData() );
+    }
+    return edge;
+}
+
+void HeightMapGenerator::passChunk( const size_t index, const float* edge ) {
+    if ((index + 1) % _checkpointInterval == 0 && (index + 1) / _checkpointInterval == _checkpoints.getSize()) {
+        column checkpoint( static_cast<int>( _size ));
+        for (size_t row = 0; row < _size; row++) {
+            checkpoint.append( edge[row] );
+        }
+        _checkpoints.append( checkpoint );
+    }
+}
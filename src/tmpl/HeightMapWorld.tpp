@@ -0,0 +1,127 @@
+#include <cmath>
+
+// independent random streams of the world, mixed into the key of every position
+enum class WorldStream : uint32_t {
+    TILE = 0,
+    CORNER = 1,
+    VERTICAL_SEAM = 2,
+    HORIZONTAL_SEAM = 3
+};
+
+// coordinates are folded to 32 bits each, so the world repeats itself every 2^32 tiles
+inline uint32_t worldKey( const CounterRng& rng, const WorldStream stream, const int64_t x, const int64_t y ) {
+    uint64_t packed = (static_cast<uint64_t>( static_cast<uint32_t>( x )) << 32) | static_cast<uint32_t>( y );
+    return CounterRng::mix( rng.streamKey( packed ) + static_cast<uint32_t>( stream ) * 0x632be5abu );
+}
+
+inline int64_t floorDiv( const int64_t value, const int64_t divisor ) {
+    int64_t res = value / divisor;
+    return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? res - 1 : res;
+}
+
+HeightMapWorld::HeightMapWorld( const uint64_t seed, const size_t size, const float amp, const size_t cacheCapacity, const float base )
+: _size( size ), _scale( CounterRng::symmetricScale( amp ))
+, _cornerAmp( amp * std::sqrt( static_cast<float>( size ))) // a seam is a walk of size steps, corners spread as much
+, _base( base ), _rng( seed ), _cache( cacheCapacity ) {
+    if (_size == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+}
+
+SharedPtr<chunk> HeightMapWorld::get( const int64_t x, const int64_t y ) {
+    TileCoord coord { x, y };
+    if (auto cached = _cache.find( coord )) {
+        return *cached;
+    }
+    auto tile = makeShared<chunk>( generate( x, y ));
+    auto bytes = tile->getBytes() + sizeof(chunk);
+    return _cache.insert( coord, std::move( tile ), bytes );
+}
+
+float HeightMapWorld::getHeight( const int64_t x, const int64_t y ) {
+    const int64_t size = static_cast<int64_t>( _size );
+    int64_t tileX = floorDiv( x, size );
+    int64_t tileY = floorDiv( y, size );
+    auto tile = get( tileX, tileY );
+    return (*tile)( static_cast<size_t>( y - tileY * size ), static_cast<size_t>( x - tileX * size ));
+}
+
+chunk HeightMapWorld::generate( const int64_t x, const int64_t y ) const {
+    chunk res( _size );
+    // seams around the tile: left, upper, right, lower
+    DynamicArray<float> seams( 4 * _size );
+    for (size_t index = 0; index < 4 * _size; index++) {
+        seams.append( 0.0f );
+    }
+    float* left  = seams.getData();
+    float* upper = left + _size;
+    float* right = upper + _size;
+    float* lower = right + _size;
+    verticalSeam( x, y, left );
+    horizontalSeam( x, y, upper );
+    verticalSeam( x + 1, y, right );
+    horizontalSeam( x, y + 1, lower );
+
+    // same recurrence as HeightMapGenerator, but the first row continues the upper seam instead of itself
+    const uint32_t key = worldKey( _rng, WorldStream::TILE, x, y );
+    for (size_t row = 0; row < _size; row++) {
+        float* curr = res.row( row );
+        const float* above = row == 0 ? upper : curr - _size;
+        float adjLeft = left[row];
+        for (size_t col = 0; col < _size; col++) {
+            auto noise = CounterRng::symmetric( CounterRng::at( key, static_cast<uint32_t>( row * _size + col )), _scale );
+            adjLeft = (adjLeft + above[col]) * 0.5f + noise;
+            curr[col] = adjLeft;
+        }
+    }
+
+    // pulling towards the right and lower seams, linearly in the distance from the opposite side
+    const float step = 1.0f / static_cast<float>( _size + 1 );
+    for (size_t row = 0; row < _size; row++) {
+        float* curr = res.row( row );
+        float diff = right[row] - curr[_size - 1];
+        for (size_t col = 0; col < _size; col++) {
+            curr[col] += diff * static_cast<float>( col + 1 ) * step;
+        }
+    }
+    const float* last = res.row( _size - 1 );
+    for (size_t col = 0; col < _size; col++) {
+        left[col] = lower[col] - last[col]; // left seam is not needed anymore, reusing it for the differences
+    }
+    for (size_t row = 0; row < _size; row++) {
+        float* curr = res.row( row );
+        float weight = static_cast<float>( row + 1 ) * step;
+        for (size_t col = 0; col < _size; col++) {
+            curr[col] += left[col] * weight;
+        }
+    }
+    return res;
+}
+
+float HeightMapWorld::corner( const int64_t x, const int64_t y ) const {
+    return _base + CounterRng::symmetric( CounterRng::at( worldKey( _rng, WorldStream::CORNER, x, y ), 0 )
+                                        , CounterRng::symmetricScale( _cornerAmp ));
+}
+
+void HeightMapWorld::verticalSeam( const int64_t x, const int64_t y, float* out ) const {
+    seam( worldKey( _rng, WorldStream::VERTICAL_SEAM, x, y ), corner( x, y ), corner( x, y + 1 ), out );
+}
+
+void HeightMapWorld::horizontalSeam( const int64_t x, const int64_t y, float* out ) const {
+    seam( worldKey( _rng, WorldStream::HORIZONTAL_SEAM, x, y ), corner( x, y ), corner( x + 1, y ), out );
+}
+
+// random walk starting next to from, bent linearly so that its step past the end lands exactly on to
+void HeightMapWorld::seam( const uint32_t streamKey, const float from, const float to, float* out ) const {
+    float value = from;
+    for (size_t index = 0; index < _size; index++) {
+        value += CounterRng::symmetric( CounterRng::at( streamKey, static_cast<uint32_t>( index )), _scale );
+        out[index] = value;
+    }
+    value += CounterRng::symmetric( CounterRng::at( streamKey, static_cast<uint32_t>( _size )), _scale );
+    const float diff = to - value;
+    const float step = 1.0f / static_cast<float>( _size + 1 );
+    for (size_t index = 0; index < _size; index++) {
+        out[index] += diff * static_cast<float>( index + 1 ) * step;
+    }
+}
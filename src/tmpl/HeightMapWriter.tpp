@@ -0,0 +1,241 @@
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+// all binary formats here are little-endian except for the image ones, which are big-endian
+template <typename U>
+inline void appendLittleEndian( std::string& out, U value ) {
+    for (size_t byte = 0; byte < sizeof(U); byte++) {
+        out.push_back( static_cast<char>( value & 0xFF ));
+        value >>= 8;
+    }
+}
+
+template <typename U>
+inline void appendBigEndian( std::string& out, const U value ) {
+    for (size_t byte = sizeof(U); byte > 0; byte--) {
+        out.push_back( static_cast<char>(( value >> (8 * (byte - 1))) & 0xFF ));
+    }
+}
+
+inline HeightMapWriterBase::HeightMapWriterBase( const std::string& path, const size_t width, const size_t height )
+: _out( path, std::ios::binary | std::ios::trunc ), _width( width ), _height( height ), _rowsWritten(0), _buffer() {
+    if (!_out) {
+        throw Exception( Exception::ErrorCode::INVALID_INPUT );
+    }
+    if (_width == 0 || _height == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+}
+
+inline void HeightMapWriterBase::beginRow() {
+    if (_rowsWritten >= _height) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    _rowsWritten++;
+    _buffer.clear();
+}
+
+inline void HeightMapWriterBase::checkFinished() const {
+    if (_rowsWritten != _height) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+}
+
+inline void HeightMapWriterBase::flush( const std::string& bytes ) {
+    _out.write( bytes.data(), static_cast<std::streamsize>( bytes.size() ));
+    if (!_out) {
+        throw Exception( "Error. Unable to write the height map file." );
+    }
+}
+
+inline uint16_t HeightMapWriterBase::quantize( const float value, const HeightRange& range ) {
+    float normalized = range.high > range.low ? (value - range.low) / (range.high - range.low) : 0.0f;
+    normalized = normalized < 0.0f ? 0.0f : (normalized > 1.0f ? 1.0f : normalized);
+    return static_cast<uint16_t>( normalized * 65535.0f + 0.5f );
+}
+
+inline RawHeightMapWriter::RawHeightMapWriter( const std::string& path, const size_t width, const size_t height )
+: HeightMapWriterBase( path, width, height ) {
+    std::string header = "HMAP";
+    appendLittleEndian<uint32_t>( header, VERSION );
+    appendLittleEndian<uint64_t>( header, _width );
+    appendLittleEndian<uint64_t>( header, _height );
+    flush( header );
+}
+
+inline void RawHeightMapWriter::writeRow( const float* row ) {
+    beginRow();
+    if constexpr (std::endian::native == std::endian::little) {
+        _out.write( reinterpret_cast<const char*>( row ), static_cast<std::streamsize>( _width * sizeof(float) ));
+        if (!_out) {
+            throw Exception( "Error. Unable to write the height map file." );
+        }
+    } else {
+        for (size_t col = 0; col < _width; col++) {
+            appendLittleEndian<uint32_t>( _buffer, std::bit_cast<uint32_t>( row[col] ));
+        }
+        flush( _buffer );
+    }
+}
+
+inline void RawHeightMapWriter::finish() {
+    checkFinished();
+    _out.flush();
+}
+
+inline PgmHeightMapWriter::PgmHeightMapWriter( const std::string& path, const size_t width, const size_t height, const HeightRange& range )
+: HeightMapWriterBase( path, width, height ), _range( range ) {
+    flush( "P5\n" + std::to_string( _width ) + " " + std::to_string( _height ) + "\n65535\n" );
+}
+
+inline void PgmHeightMapWriter::writeRow( const float* row ) {
+    beginRow();
+    for (size_t col = 0; col < _width; col++) {
+        appendBigEndian<uint16_t>( _buffer, quantize( row[col], _range ));
+    }
+    flush( _buffer );
+}
+
+inline void PgmHeightMapWriter::finish() {
+    checkFinished();
+    _out.flush();
+}
+
+static const size_t STORED_BLOCK_MAX = 65535;
+
+inline PngHeightMapWriter::PngHeightMapWriter( const std::string& path, const size_t width, const size_t height, const HeightRange& range )
+: HeightMapWriterBase( path, width, height ), _range( range ), _adler(1), _scanline() {
+    if (_width > 0x7FFFFFFF || _height > 0x7FFFFFFF) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    flush( std::string( "\x89PNG\r\n\x1a\n", 8 ));
+
+    std::string header;
+    appendBigEndian<uint32_t>( header, static_cast<uint32_t>( _width ));
+    appendBigEndian<uint32_t>( header, static_cast<uint32_t>( _height ));
+    header.push_back(16); // bit depth
+    header.push_back(0);  // grayscale
+    header.push_back(0);  // deflate
+    header.push_back(0);  // adaptive filtering, only the "none" filter is used
+    header.push_back(0);  // no interlace
+    writeChunk( "IHDR", header );
+}
+
+// every scanline is a filter byte followed by the samples. it's split into stored blocks of at most 65535 bytes,
+// the first IDAT also carries the zlib header and the last one the final block flag and the adler32 of the stream
+inline void PngHeightMapWriter::writeRow( const float* row ) {
+    beginRow();
+    _scanline.clear();
+    _scanline.push_back(0);
+    for (size_t col = 0; col < _width; col++) {
+        appendBigEndian<uint16_t>( _scanline, quantize( row[col], _range ));
+    }
+    _adler = adler32( _adler, _scanline.data(), _scanline.size() );
+
+    if (_rowsWritten == 1) {
+        _buffer.push_back( 0x78 ); // deflate, 32k window
+        _buffer.push_back( 0x01 ); // no preset dictionary, fastest level, header divisible by 31
+    }
+    for (size_t offset = 0; offset < _scanline.size(); offset += STORED_BLOCK_MAX) {
+        size_t length = _scanline.size() - offset < STORED_BLOCK_MAX ? _scanline.size() - offset : STORED_BLOCK_MAX;
+        bool isFinal = _rowsWritten == _height && offset + length == _scanline.size();
+        _buffer.push_back( isFinal ? 1 : 0 );
+        appendLittleEndian<uint16_t>( _buffer, static_cast<uint16_t>( length ));
+        appendLittleEndian<uint16_t>( _buffer, static_cast<uint16_t>( ~length ));
+        _buffer.append( _scanline, offset, length );
+    }
+    if (_rowsWritten == _height) {
+        appendBigEndian<uint32_t>( _buffer, _adler );
+    }
+    writeChunk( "IDAT", _buffer );
+}
+
+inline void PngHeightMapWriter::finish() {
+    checkFinished();
+    writeChunk( "IEND", std::string() );
+    _out.flush();
+}
+
+inline void PngHeightMapWriter::writeChunk( const char* type, const std::string& data ) {
+    std::string framing;
+    appendBigEndian<uint32_t>( framing, static_cast<uint32_t>( data.size() ));
+    framing.append( type, 4 );
+    flush( framing );
+    flush( data );
+
+    uint32_t crc = crc32( 0xFFFFFFFFu, type, 4 );
+    crc = crc32( crc, data.data(), data.size() ) ^ 0xFFFFFFFFu;
+    framing.clear();
+    appendBigEndian<uint32_t>( framing, crc );
+    flush( framing );
+}
+
+inline uint32_t PngHeightMapWriter::crc32( uint32_t crc, const char* data, const size_t size ) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> res {};
+        for (uint32_t index = 0; index < 256; index++) {
+            uint32_t value = index;
+            for (size_t bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            res[index] = value;
+        }
+        return res;
+    }();
+    for (size_t index = 0; index < size; index++) {
+        crc = table[(crc ^ static_cast<uint8_t>( data[index] )) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+inline uint32_t PngHeightMapWriter::adler32( const uint32_t adler, const char* data, const size_t size ) {
+    static const uint32_t MOD = 65521;
+    static const size_t NMAX = 5552; // the most bytes which can be summed before the 32-bit sums overflow
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    for (size_t offset = 0; offset < size; offset += NMAX) {
+        size_t end = size - offset < NMAX ? size : offset + NMAX;
+        for (size_t index = offset; index < end; index++) {
+            a += static_cast<uint8_t>( data[index] );
+            b += a;
+        }
+        a %= MOD;
+        b %= MOD;
+    }
+    return (b << 16) | a;
+}
+
+inline CsvHeightMapWriter::CsvHeightMapWriter( const std::string& path, const size_t width, const size_t height )
+: HeightMapWriterBase( path, width, height ) {}
+
+inline void CsvHeightMapWriter::writeRow( const float* row ) {
+    beginRow();
+    char number[32];
+    for (size_t col = 0; col < _width; col++) {
+        auto res = std::to_chars( number, number + sizeof(number), row[col] );
+        _buffer.append( number, res.ptr );
+        _buffer.push_back( col + 1 == _width ? '\n' : ',' );
+    }
+    flush( _buffer );
+}
+
+inline void CsvHeightMapWriter::finish() {
+    checkFinished();
+    _out.flush();
+}
+
+inline UniquePtr<IHeightMapWriter> makeHeightMapWriter( const HeightMapFormat format, const std::string& path
+                                                      , const size_t width, const size_t height, const HeightRange& range ) {
+    switch (format) {
+    case HeightMapFormat::RAW:
+        return makeUnique<RawHeightMapWriter>( path, width, height );
+    case HeightMapFormat::PGM:
+        return makeUnique<PgmHeightMapWriter>( path, width, height, range );
+    case HeightMapFormat::PNG:
+        return makeUnique<PngHeightMapWriter>( path, width, height, range );
+    default:
+        return makeUnique<CsvHeightMapWriter>( path, width, height );
+    }
+}
@@ -12,12 +12,13 @@ LazySequence<T>::LazySequence( const T& value )
 , _generator( makeShared<FiniteGenerator<T>>( value ) )
 , _items( makeUnique<ArraySequence<T>>() ) {}
 
+// the data moves into the generator only, the cache is filled from it on demand
 template <typename T>
 LazySequence<T>::LazySequence( ArraySequence<T>& data ) 
 : _size(data.getSize()), _offset(0)
 , _ordinality( Option<Ordinal>(data.getSize()) )
 , _generator( makeShared<FiniteGenerator<T>>( std::move(data) ) )
-, _items( makeUnique<ArraySequence<T>>( std::move(data) ) ) {}
+, _items( makeUnique<ArraySequence<T>>() ) {}
 
 template <typename T>
 LazySequence<T>::LazySequence( const size_t arity
@@ -46,6 +47,14 @@ LazySequence<T>::LazySequence( UniquePtr<IGenerator<T>>&& generator
 , _generator( std::move(generator) )
 , _items( makeUnique<ArraySequence<T>>( data) ) {}
 
+template <typename T>
+LazySequence<T>::LazySequence( const std::function<Coroutine<T>()>& body
+                             , const Cardinal& size
+                             , const Option<Ordinal>& ordinality )
+: _size( size ), _offset(0)
+, _ordinality( ordinality )
+, _generator( makeShared<CoroutineGenerator<T>>( body ) ) {}
+
 template <typename T>
 LazySequence<T>::LazySequence( const LazySequence<T>& other ) {
     _size       = other._size;
@@ -63,6 +72,7 @@ LazySequence<T>& LazySequence<T>::operator=( const LazySequence<T>& other ) {
         _ordinality = other._ordinality;
         _generator  = other._generator;
         *_items     = *other._items;
+        _spill      = SharedPtr<SpillFile<T>>();
     }
     return *this;
 }
@@ -71,11 +81,15 @@ template <typename T>
 LazySequence<T>::LazySequence( LazySequence<T>&& other ) {
     _generator    = std::move(other._generator);
     _items        = std::move(other._items);
+    _spill        = std::move(other._spill);
+    _consumers    = std::move(other._consumers);
     _offset       = other._offset;
     _size         = other._size;
     _ordinality   = other._ordinality;
     other._offset = 0;
     other._size   = 0;
+    other._cache.update(0);
+    _cache.update( _items ? _items->getSize() * sizeof(T) : 0 ); // the charge moves along with the items
 }
 
 template <typename T>
@@ -83,11 +97,15 @@ LazySequence<T>& LazySequence<T>::operator=( LazySequence<T>&& other ) {
     if (this != &other) {
         _generator    = std::move(other._generator);
         _items        = std::move(other._items);
+        _spill        = std::move(other._spill);
+        _consumers    = std::move(other._consumers);
         _offset       = other._offset;
         _size         = other._size;
         _ordinality   = other._ordinality;
         other._offset = 0;
         other._size   = 0;
+        other._cache.update(0);
+        _cache.update( _items ? _items->getSize() * sizeof(T) : 0 );
     }
     return *this;
 }
@@ -131,9 +149,39 @@ SharedPtr<LazySequence<T2>> LazySequence<T>::create( UniquePtr<IGenerator<T2>>&&
     return makeShared<LazySequence<T2>>( std::move(generator), size, ordinality, data );
 }
 
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::create( const std::function<Coroutine<T>()>& body
+                                                  , const Cardinal& size
+                                                  , const Option<Ordinal>& ordinality ) {
+    return makeShared<LazySequence<T>>( body, size, ordinality );
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::fromFile( const std::string& path ) requires std::is_trivially_copyable_v<T> {
+    return fromSource( SharedPtr<ContiguousSource<T>>( makeUnique<MappedFile<T>>( path )));
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::borrow( const T* data, const size_t size, const std::function<void()>& release ) {
+    return fromSource( SharedPtr<ContiguousSource<T>>( makeUnique<BorrowedBuffer<T>>( data, size, release )));
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::fromSource( SharedPtr<ContiguousSource<T>> source ) {
+    size_t size = source->getSize();
+    return create<T>( makeUnique<SourceGenerator<T>>( source ), size, Option<Ordinal>( size ));
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::fromText( const std::string& path, const size_t blockSize )
+    requires std::is_arithmetic_v<T> {
+    return create<T>( makeUnique<TextGenerator<T>>( path, blockSize ), Cardinal::infiniteCardinal::BETH_0, Option<Ordinal>() );
+}
+
 template <typename T>
 T LazySequence<T>::getFirst() {
-    if (_offset > 0) {
+    if (_offset > 0 && !(_spill && _spill->contains(0))) {
+        LAZY_COUNT( dematerializedAccesses, 1 );
         throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
     } else {
         return (*this)[0];
@@ -145,37 +193,60 @@ T LazySequence<T>::getLast() {
     if (!isFinite()) {
         throw Exception( Exception::ErrorCode::INFINITE_CALCULATION );
     } else {
+        LAZY_COUNT( generatorCalls, 1 );
         return _generator->get(static_cast<size_t>(getSize()) - 1);
     }
 }
 
 template <typename T>
 T LazySequence<T>::operator[]( const Ordinal& index ) {
+    LAZY_TIME( nanoseconds );
     trimCache();
+    resolveOrdinality();
     if (_ordinality.hasValue()) {
         if (index < 0 || index >= _ordinality.get()) {
             throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); 
         }
         if (index.isFinite()) {
+            if (_generator->isRandomAccess()) { // nothing to gain from caching
+                LAZY_COUNT( generatorCalls, 1 );
+                return _generator->get( index );
+            }
             if (_items->isEmpty()) {
+                LAZY_COUNT( cacheMisses, 1 );
                 for ( auto i = 0; i <= index; i++ ) {
+                    LAZY_COUNT( generatorCalls, 1 );
                     auto a = _generator->getNext();
                     _items->append( a );
                 }
                 return (*_items)[static_cast<size_t>(index)];
             } else {
                 if (_offset <= index && index < _offset + _items->getSize()) {
+                    LAZY_COUNT( cacheHits, 1 );
                     return (*_items)[static_cast<size_t>(index) - static_cast<size_t>(_offset)];
                 } else if (index >= _offset + _items->getSize()) {
+                    LAZY_COUNT( cacheMisses, 1 );
                     while (index > _offset + _items->getSize() - 1) {
+                        LAZY_COUNT( generatorCalls, 1 );
                         _items->append( _generator->getNext() );
                     }
                     return (*_items)[static_cast<size_t>(index) - static_cast<size_t>(_offset)];
                 } else {
-                    throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
+                    LAZY_COUNT( cacheMisses, 1 );
+                    Option<T> spilled = readSpilled( index );
+                    if (spilled.hasValue()) {
+                        return spilled.get();
+                    }
+                    if (!_generator->canRevisit()) { // get() of the other generators may index differently
+                        throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
+                    }
+                    LAZY_COUNT( generatorCalls, 1 );
+                    return _generator->get( index );
                 }
             }
         } else {
+            LAZY_COUNT( cacheMisses, 1 );
+            LAZY_COUNT( generatorCalls, 1 );
             return _generator->get( index );
         }
     } else { 
@@ -185,21 +256,35 @@ T LazySequence<T>::operator[]( const Ordinal& index ) {
             throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); 
         } 
         if (_items->isEmpty()) {
+            LAZY_COUNT( cacheMisses, 1 );
                 for ( auto i = 0; i <= index; i++ ) {
+                    LAZY_COUNT( generatorCalls, 1 );
                     auto a = _generator->getNext();
                     _items->append( a );
                 }
                 return (*_items)[static_cast<size_t>(index)];
         } else {
             if (_offset <= index && index < _offset + _items->getSize()) {
+                LAZY_COUNT( cacheHits, 1 );
                 return (*_items)[static_cast<size_t>(index) - static_cast<size_t>(_offset)];
             } else if (index >= _offset + _items->getSize()) {
+                LAZY_COUNT( cacheMisses, 1 );
                 while (index > _offset + _items->getSize() - 1) {
+                    LAZY_COUNT( generatorCalls, 1 );
                     _items->append( _generator->getNext() );
                 }
                 return (*_items)[static_cast<size_t>(index) - static_cast<size_t>(_offset)];
             } else {
-                throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
+                LAZY_COUNT( cacheMisses, 1 );
+                Option<T> spilled = readSpilled( index );
+                if (spilled.hasValue()) {
+                    return spilled.get();
+                }
+                if (!_generator->canRevisit()) {
+                    throw Exception( Exception::ErrorCode::DEMATERIALIZED_ACCESS );
+                }
+                LAZY_COUNT( generatorCalls, 1 );
+                return _generator->get( index );
             }
         }
     }
@@ -212,7 +297,7 @@ Cardinal LazySequence<T>::getSize() const {
 
 template <typename T>
 size_t LazySequence<T>::getMaterializedCount() const { 
-    return _generator->_items->getSize();
+    return _offset + _items->getSize();
 }
 
 template <typename T>
@@ -220,6 +305,16 @@ ArraySequence<T> LazySequence<T>::getMaterialized() const {
     return *_items;
 }
 
+template <typename T>
+ArraySequence<T> LazySequence<T>::getMaterializedTail( const size_t count ) const {
+    ArraySequence<T> res;
+    size_t size = _items->getSize();
+    for (size_t i = size > count ? size - count : 0; i < size; i++) {
+        res.append( (*_items)[static_cast<int>(i)] );
+    }
+    return res;
+}
+
 template <typename T>
 bool LazySequence<T>::isEmpty() const {
     return getSize() == 0;
@@ -236,7 +331,7 @@ SharedPtr<LazySequence<T>> LazySequence<T>::append( const T& value ) {
     auto newOrd = _ordinality.hasValue()
             ? Option<Ordinal>( _ordinality.get() + 1 )
             : Option<Ordinal>();
-    return create<T>( std::move(gen), _size + 1, newOrd, *_items );
+    return create<T>( std::move(gen), _size + 1, newOrd );
 }
 
 template <typename T>
@@ -245,7 +340,7 @@ SharedPtr<LazySequence<T>> LazySequence<T>::append( const LazySequence<T>& value
     auto newOrd = _ordinality.hasValue() && value._ordinality.hasValue()
             ? Option<Ordinal>( _ordinality.get() + value._ordinality.get() ) 
             : Option<Ordinal>();
-    return create<T>( std::move(gen), _size + 1, newOrd, *_items );
+    return create<T>( std::move(gen), _size + 1, newOrd );
 }
 
 template <typename T>
@@ -254,12 +349,7 @@ SharedPtr<LazySequence<T>> LazySequence<T>::prepend( const T& value ) {
     auto newOrd = _ordinality.hasValue()
             ? Option<Ordinal>( 1 + _ordinality.get()) 
             : Option<Ordinal>();
-    ArraySequence<T> newItems;
-    if (_offset == 0) {
-        newItems.prepend(value);
-    }
-    newItems.concat( *_items );
-    return create<T>( std::move(gen), _size + 1, newOrd, newItems );
+    return create<T>( std::move(gen), _size + 1, newOrd );
 }
 
 template <typename T>
@@ -398,11 +488,52 @@ SharedPtr<LazySequence<T2>> LazySequence<T>::map( const std::function<T2(T)>& fu
 }
 
 template <typename T>
-SharedPtr<LazySequence<T>> LazySequence<T>::where( const std::function<bool(T)>& func ) { //     ,      
-    auto gen = makeUnique<WhereGenerator<T>>( func, this->sharedFromThis() );             //   
+SharedPtr<LazySequence<T>> LazySequence<T>::where( const std::function<bool(T)>& func, const ScanBudget& budget ) { //     ,      
+    auto gen = makeUnique<WhereGenerator<T>>( func, this->sharedFromThis(), budget );             //   
     return create<T>( std::move(gen), _size, Option<Ordinal>() ); 
 }
 
+template <typename T>
+template <typename Aggregate>
+SharedPtr<LazySequence<typename Aggregate::Result>> LazySequence<T>::slide( const size_t width ) {
+    if (width == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    using TOut = typename Aggregate::Result;
+    auto gen = makeUnique<WindowGenerator<T, Aggregate>>( this->sharedFromThis(), width );
+    if (_ordinality.hasValue() && _ordinality.get().isFinite()) {
+        size_t count = static_cast<size_t>( _ordinality.get() );
+        count = count >= width ? count - width + 1 : 0;
+        return create<TOut>( std::move(gen), Cardinal( count ), Option<Ordinal>( Ordinal( count )));
+    }
+    return create<TOut>( std::move(gen), _size, Option<Ordinal>() ); // transfinite indices have no windows
+}
+
+template <typename T>
+SharedPtr<LazySequence<ArraySequence<T>>> LazySequence<T>::window( const size_t width ) {
+    return slide<WindowElements<T>>( width );
+}
+
+template <typename T>
+SharedPtr<LazySequence<WideSum<T>>> LazySequence<T>::rollingSum( const size_t width ) requires std::is_arithmetic_v<T> {
+    return slide<RollingSum<T>>( width );
+}
+
+template <typename T>
+SharedPtr<LazySequence<double>> LazySequence<T>::rollingMean( const size_t width ) requires std::is_arithmetic_v<T> {
+    return slide<RollingMean<T>>( width );
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::rollingMin( const size_t width ) {
+    return slide<RollingMin<T>>( width );
+}
+
+template <typename T>
+SharedPtr<LazySequence<T>> LazySequence<T>::rollingMax( const size_t width ) {
+    return slide<RollingMax<T>>( width );
+}
+
 template <typename T>
 template <typename T2>
 T2 LazySequence<T>::foldl( const std::function<T2(T2, T)>& func, const T2& base ) {
@@ -438,6 +569,9 @@ T2 LazySequence<T>::foldr( const std::function<T2(T, T2)>& func, const T2& base
 
 template <typename T>
 const T& LazySequence<T>::memoiseNext() {
+    LAZY_TRACE();
+    LAZY_TIME( nanoseconds );
+    LAZY_COUNT( generatorCalls, 1 );
     _items->append( _generator->getNext() );
     trimCache();
     return (*_items)[ _items->getSize() - 1];
@@ -445,16 +579,75 @@ const T& LazySequence<T>::memoiseNext() {
 
 template <typename T>
 T LazySequence<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
     if (index.isFinite()) {
         return (*this)[index];
     } else {
+        LAZY_TIME( nanoseconds );
+        LAZY_COUNT( generatorCalls, 1 );
         return this->_generator->get( index );
     }
 }
 
+// the cached part is copied in one pass and the part ahead of it is pulled without trimming between elements,
+// the cache is trimmed once the block is complete
+template <typename T>
+size_t LazySequence<T>::readBlock( const size_t from, const size_t count, ArraySequence<T>& block, ScanStatus& status ) {
+    LAZY_TIME( nanoseconds );
+    resolveOrdinality();
+    size_t end = from + count;
+    if (_ordinality.hasValue() && _ordinality.get().isFinite()) {
+        size_t ordinality = static_cast<size_t>( _ordinality.get() );
+        end = ordinality < end ? ordinality : end;
+    }
+    size_t index = from;
+    status = end < from + count ? ScanStatus::FINISHED : ScanStatus::FOUND;
+    auto put = [&block, from]( const size_t index, const T& value ) {
+        if (index - from < block.getSize()) {
+            block[static_cast<int>( index - from )] = value;
+        } else {
+            block.append( value );
+        }
+    };
+
+    if (_generator->isRandomAccess()) {
+        for (; index < end; index++) {
+            LAZY_COUNT( generatorCalls, 1 );
+            put( index, _generator->get( Ordinal( index )));
+        }
+        return index > from ? index - from : 0;
+    }
+    for (; index < end && index < _offset; index++) { // behind the cache
+        put( index, (*this)[Ordinal( index )] );
+    }
+    size_t cachedEnd = _offset + _items->getSize();
+    if (index < end && index < cachedEnd) {
+        LAZY_COUNT( cacheHits, 1 );
+    }
+    for (; index < end && index < cachedEnd; index++) {
+        put( index, (*_items)[static_cast<int>( index - _offset )] );
+    }
+    while (index < end) {
+        ScanStatus scanned = scanNext( Option<ScanBudget>() );
+        if (scanned != ScanStatus::FOUND) {
+            status = scanned;
+            break;
+        }
+        LAZY_COUNT( generatorCalls, 1 );
+        T next = _generator->getNext();
+        _items->append( next );
+        if (_offset + _items->getSize() > index) { // the elements between the cache and from are only cached
+            put( index, next );
+            index++;
+        }
+    }
+    trimCache();
+    return index > from ? index - from : 0;
+}
+
 template <typename T>
 bool LazySequence<T>::canMemoiseNext() {
-    return _generator->hasNext();
+    return scanNext( Option<ScanBudget>() ) == ScanStatus::FOUND;
 }
 
 template <typename T>
@@ -466,10 +659,341 @@ Option<T> LazySequence<T>::tryMemoiseNext() {
     }
 }
 
+template <typename T>
+ScanStatus LazySequence<T>::tryMemoiseNext( const ScanBudget& budget ) {
+    ScanStatus status = scanNext( Option<ScanBudget>( budget ));
+    if (status == ScanStatus::FOUND) {
+        memoiseNext();
+    }
+    return status;
+}
+
+template <typename T>
+ScanStatus LazySequence<T>::scanNext( const Option<ScanBudget>& budget ) {
+    ScanStatus status = _generator->scan( budget );
+    if (status == ScanStatus::FINISHED) {
+        resolveOrdinality();
+    }
+    return status;
+}
+
+// neither the caches nor the consumer positions of the parents are synchronized, so no sibling may read them
+template <typename T>
+void LazySequence<T>::enablePrefetch( const size_t depth ) {
+    if (!isPrefetching()) {
+        PipelinePlan plan;
+        plan.visit( *this );
+        for (size_t node = 0; node < plan.getNodeCount(); node++) {
+            if (plan.getNode( node ).id != this && plan.getNode( node ).consumers > 1) {
+                throw Exception( Exception::ErrorCode::SHARED_PARENT );
+            }
+        }
+        _generator = SharedPtr<IGenerator<T>>( makeUnique<PrefetchGenerator<T>>( _generator, depth, _offset + _items->getSize() ));
+    }
+}
+
+template <typename T>
+bool LazySequence<T>::isPrefetching() {
+    return dynamic_cast<PrefetchGenerator<T>*>( static_cast<IGenerator<T>*>( _generator )) != nullptr;
+}
+
+template <typename T>
+void LazySequence<T>::enableSpill( const std::string& directory ) requires std::is_trivially_copyable_v<T> {
+    if (!_spill) {
+        _spill = makeShared<SpillFile<T>>( _offset, directory );
+    }
+}
+
+template <typename T>
+bool LazySequence<T>::isSpilling() const {
+    return _spill;
+}
+
+template <typename T>
+Option<T> LazySequence<T>::readSpilled( const Ordinal& index ) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_spill && index.isFinite() && _spill->contains( static_cast<size_t>(index) )) {
+            LAZY_COUNT( spillReads, 1 );
+            return Option<T>( _spill->read( static_cast<size_t>(index) ));
+        }
+    }
+    return Option<T>();
+}
+
+// elements a consumer is yet to read are kept while they are among the newest CACHE_LAG_MAX_SIZE,
+// a consumer further behind than that reads from the spill file or a random access generator if there is one
 template <typename T>
 void LazySequence<T>::trimCache() {
     if (_items->getSize() >= CACHE_MAX_SIZE) {
-        *_items = *static_cast<ArraySequence<T>*>(_items->getSubSequence( _items->getSize() - CACHE_DECREASE_SIZE, _items->getSize()));
-        _offset += CACHE_OFFSET_INCREASE;
+        size_t count = _items->getSize() - CACHE_DECREASE_SIZE;
+        size_t droppable = getDroppableCount();
+        count = droppable < count ? droppable : count;
+        if (count > 0) {
+            LAZY_TRACE();
+            LAZY_COUNT( trims, 1 );
+            LAZY_COUNT( bytesTrimmed, count * sizeof(T) );
+            dropOldest( count );
+        }
+    }
+    _cache.update( _items->getSize() * sizeof(T) );
+}
+
+template <typename T>
+size_t LazySequence<T>::attachConsumer( const size_t position ) {
+    for (size_t consumer = 0; consumer < _consumers.getSize(); consumer++) {
+        if (_consumers[consumer] == FREE_CONSUMER) {
+            _consumers[consumer] = position;
+            return consumer;
+        }
+    }
+    _consumers.append( position );
+    return _consumers.getSize() - 1;
+}
+
+template <typename T>
+void LazySequence<T>::detachConsumer( const size_t consumer ) {
+    _consumers[consumer] = FREE_CONSUMER;
+}
+
+template <typename T>
+size_t LazySequence<T>::getSlowestConsumer() const {
+    size_t slowest = FREE_CONSUMER;
+    for (size_t consumer = 0; consumer < _consumers.getSize(); consumer++) {
+        size_t position = _consumers[consumer];
+        slowest = position < slowest ? position : slowest;
+    }
+    return slowest;
+}
+
+template <typename T>
+size_t LazySequence<T>::getDroppableCount() const {
+    size_t slowest = getSlowestConsumer();
+    size_t read = slowest > _offset ? slowest - _offset : 0;
+    if (_items->getSize() > CACHE_LAG_MAX_SIZE) {
+        size_t lagged = _items->getSize() - CACHE_LAG_MAX_SIZE;
+        read = read > lagged ? read : lagged;
+    }
+    return read;
+}
+
+// the element is computed by whichever consumer reaches it first, the others read it from the cache
+template <typename T>
+T LazySequence<T>::readNext( const size_t consumer ) {
+    size_t position = _consumers[consumer];
+    if (position < _offset) {
+        return readLagged( consumer );
+    }
+    size_t cachedEnd = _offset + _items->getSize();
+    T res = position < cachedEnd ? (*_items)[static_cast<int>( position - _offset )]
+          : position == cachedEnd ? memoiseNext()
+          : (*this)[Ordinal( position )];
+    _consumers[consumer] = position + 1;
+    return res;
+}
+
+template <typename T>
+T LazySequence<T>::readLagged( const size_t consumer ) {
+    size_t position = _consumers[consumer];
+    Option<T> spilled = readSpilled( Ordinal( position ));
+    if (!spilled.hasValue() && !_generator->isRandomAccess()) {
+        LAZY_COUNT( dematerializedAccesses, 1 );
+        throw Exception( Exception::ErrorCode::CONSUMER_LAGGED );
+    }
+    T res = spilled.hasValue() ? spilled.get() : _generator->get( Ordinal( position ));
+    _consumers[consumer] = position + 1;
+    return res;
+}
+
+template <typename T>
+bool LazySequence<T>::canReadNext( const size_t consumer ) {
+    if (_consumers[consumer] < getMaterializedCount() || _generator->hasNext()) {
+        return true;
+    }
+    // an exhausted scan budget throws from hasNext(), a derived generator mustn't take it for the end
+    resolveOrdinality();
+    return false;
+}
+
+template <typename T>
+void LazySequence<T>::resolveOrdinality() {
+    if (!_ordinality.hasValue()) {
+        auto ordinality = _generator->getOrdinality();
+        if (ordinality.hasValue()) {
+            _ordinality = ordinality;
+            _size = static_cast<size_t>( ordinality.get() );
+        }
+    }
+}
+
+// the offset follows the amount actually dropped, so a cache which has grown past the limit in one go stays consistent
+template <typename T>
+void LazySequence<T>::dropOldest( const size_t count ) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_spill) {
+            _spill->append( _items->getData(), count );
+        }
+    }
+    Sequence<T>* rest = _items->getSubSequence( static_cast<int>( count ), static_cast<int>( _items->getSize() ));
+    *_items = std::move( *static_cast<ArraySequence<T>*>( rest ));
+    delete rest;
+    _offset += count;
+}
+
+// whole blocks are evicted, but the newest element always stays: memoiseNext() returns a reference to it.
+// elements the consumers are still owed stay as well, the same as in trimCache()
+template <typename T>
+size_t LazySequence<T>::SequenceCache::evictOldest( const size_t bytes ) {
+    if (!_owner->_items || _owner->_items->getSize() <= 1) {
+        return 0;
+    }
+    size_t count = (bytes + sizeof(T) - 1) / sizeof(T);
+    count = (count + EVICTION_BLOCK - 1) / EVICTION_BLOCK * EVICTION_BLOCK;
+    count = count < _owner->_items->getSize() - 1 ? count : _owner->_items->getSize() - 1;
+    size_t droppable = _owner->getDroppableCount();
+    count = droppable < count ? droppable : count;
+    if (count == 0) {
+        return 0;
+    }
+    LAZY_TRACE();
+    _owner->dropOldest( count );
+    return count * sizeof(T);
+}
+
+template <typename T>
+CacheFootprint LazySequence<T>::SequenceCache::getFootprint() const {
+    CacheFootprint res;
+    res.owner = _owner;
+    if (_owner->_generator.operator->() != nullptr) {
+        res.generator      = _owner->_generator->getName();
+        res.generatorBytes = _owner->_generator->getStateBytes();
+    }
+    if (_owner->_items) {
+        res.cached     = _owner->_items->getSize();
+        res.cacheBytes = res.cached * sizeof(T);
+    }
+    if (_owner->_spill) {
+        res.spilledBytes = _owner->_spill->getBytes();
+    }
+    return res;
+}
+
+template <typename T>
+void LazySequence<T>::save( std::ostream& out ) const {
+    SnapshotWriter writer( out );
+    writer.writeHeader();
+    saveState( writer );
+}
+
+template <typename T>
+void LazySequence<T>::save( const std::string& path ) const {
+    std::ofstream out( path, std::ios::binary );
+    if (!out) {
+        throw Exception( "Error. Unable to open the snapshot file." );
+    }
+    save( out );
+}
+
+template <typename T>
+void LazySequence<T>::restore( std::istream& in ) {
+    SnapshotReader reader( in );
+    reader.readHeader();
+    restoreState( reader );
+}
+
+template <typename T>
+void LazySequence<T>::restore( const std::string& path ) {
+    std::ifstream in( path, std::ios::binary );
+    if (!in) {
+        throw Exception( "Error. Unable to open the snapshot file." );
     }
-}
\ No newline at end of file
+    restore( in );
+}
+
+// the name of the generator guards against restoring into a sequence built another way
+template <typename T>
+void LazySequence<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _generator->getName() );
+    out.write( _offset );
+    out.write( _ordinality );
+    out.write( *_items );
+    _generator->saveState( out );
+}
+
+// elements spilled before belong to another frontier, so the spill file starts over
+template <typename T>
+void LazySequence<T>::restoreState( SnapshotReader& in ) {
+    in.expect( _generator->getName() );
+    size_t offset = in.read<size_t>();
+    auto ordinality = in.read<Option<Ordinal>>();
+    auto items = in.read<ArraySequence<T>>();
+    _generator->restoreState( in );
+    _offset = offset;
+    _ordinality = ordinality;
+    *_items = std::move( items );
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (_spill) {
+            _spill->clear( _offset );
+        }
+    }
+    _cache.update( _items->getSize() * sizeof(T) );
+}
+
+template <typename T>
+std::string LazySequence<T>::explain( const ExplainFormat format ) const {
+    PipelinePlan plan;
+    plan.visit( *this );
+    return plan.render( format );
+}
+
+template <typename T>
+PipelineNode LazySequence<T>::describe() const {
+    PipelineNode node;
+    node.id           = this;
+    node.generator    = _generator->getName();
+    node.ordinality   = _ordinality;
+    node.cached       = _items->getSize();
+    node.materialized = _offset + _items->getSize();
+    node.cacheBytes   = _items->getSize() * sizeof(T);
+    node.pullFactor   = _generator->getPullFactor();
+    for (size_t consumer = 0; consumer < _consumers.getSize(); consumer++) {
+        node.consumers += _consumers[consumer] != FREE_CONSUMER ? 1 : 0;
+    }
+#ifdef LAZY_SEQUENCE_COUNTERS
+    node.counters = _counters;
+    _generator->addCounters( node.counters );
+#endif
+    return node;
+}
+
+template <typename U>
+void PipelineVisitor::visit( const LazySequence<U>& seq ) {
+    if (_current != nullptr) {
+        onEdge( _current, &seq );
+        if (!_followParents) {
+            return;
+        }
+    }
+    if (!markVisited( &seq )) {
+        return;
+    }
+    onNode( seq.describe() );
+    const void* previous = _current;
+    _current = &seq;
+    seq._generator->visitParents( *this );
+    _current = previous;
+}
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+template <typename T>
+CounterSnapshot LazySequence<T>::getCounters( const CounterScope scope ) const {
+    CounterCollector collector( scope );
+    collector.visit( *this );
+    return collector.getSnapshot();
+}
+
+template <typename T>
+void LazySequence<T>::resetCounters() {
+    _counters = SequenceCounters();
+    _generator->resetCounters();
+}
+#endif // LAZY_SEQUENCE_COUNTERS
@@ -0,0 +1,74 @@
+template <typename T>
+LazySequence<T>::LazySequenceCursor::LazySequenceCursor()
+: _observed( SharedPtr<LazySequence<T>>() ), _block(), _current( nullptr ), _end( nullptr ), _base( 0 ), _batch( 0 )
+, _status( ScanStatus::FINISHED ) {}
+
+template <typename T>
+LazySequence<T>::LazySequenceCursor::LazySequenceCursor( SharedPtr<LazySequence<T>> observed, const size_t from, const size_t batch )
+: _observed( observed ), _block(), _current( nullptr ), _end( nullptr ), _base( from ), _batch( batch > 0 ? batch : 1 )
+, _status( ScanStatus::FOUND ) {
+    refill();
+}
+
+// the block keeps its buffer when moved, so the pointers stay valid
+template <typename T>
+LazySequence<T>::LazySequenceCursor::LazySequenceCursor( LazySequenceCursor&& other )
+: _observed( std::move( other._observed )), _block( std::move( other._block ))
+, _current( other._current ), _end( other._end ), _base( other._base ), _batch( other._batch ), _status( other._status ) {
+    other._current = nullptr;
+    other._end = nullptr;
+}
+
+template <typename T>
+LazySequence<T>::LazySequenceCursor& LazySequence<T>::LazySequenceCursor::operator=( LazySequenceCursor&& other ) {
+    if (this != &other) {
+        this->_observed = std::move( other._observed );
+        this->_block = std::move( other._block );
+        this->_current = other._current;
+        this->_end = other._end;
+        this->_base = other._base;
+        this->_batch = other._batch;
+        this->_status = other._status;
+        other._current = nullptr;
+        other._end = nullptr;
+    }
+    return *this;
+}
+
+template <typename T>
+LazySequence<T>::LazySequenceCursor& LazySequence<T>::LazySequenceCursor::operator++() {
+    if (++this->_current == this->_end) {
+        this->_base += static_cast<size_t>( this->_end - this->_block.getData() );
+        refill();
+    }
+    return *this;
+}
+
+template <typename T>
+void LazySequence<T>::LazySequenceCursor::operator++(int) {
+    ++(*this);
+}
+
+template <typename T>
+size_t LazySequence<T>::LazySequenceCursor::getIndex() const {
+    if (this->_current == this->_end) {
+        return this->_base;
+    }
+    return this->_base + static_cast<size_t>( this->_current - this->_block.getData() );
+}
+
+template <typename T>
+void LazySequence<T>::LazySequenceCursor::refill() {
+    this->_current = nullptr;
+    this->_end = nullptr;
+    size_t filled = this->_observed->readBlock( this->_base, this->_batch, this->_block, this->_status );
+    if (filled > 0) {
+        this->_current = this->_block.getData();
+        this->_end = this->_current + filled;
+    }
+}
+
+template <typename T>
+LazySequence<T>::LazySequenceStream LazySequence<T>::stream( const size_t from, const size_t batch ) {
+    return LazySequenceStream( this->sharedFromThis(), from, batch );
+}
@@ -0,0 +1,96 @@
+template <typename K, typename V, typename Hash>
+LruCache<K, V, Hash>::LruCache( const size_t capacity )
+: _capacity( capacity ), _bytes(0), _hits(0), _misses(0), _evictions(0), _entries(), _index() {}
+
+template <typename K, typename V, typename Hash>
+LruCache<K, V, Hash>::LruCache( const LruCache<K, V, Hash>& other )
+: _capacity( other._capacity ), _bytes( other._bytes ), _hits( other._hits ), _misses( other._misses )
+, _evictions( other._evictions ), _entries( other._entries ), _index() {
+    reindex();
+}
+
+template <typename K, typename V, typename Hash>
+LruCache<K, V, Hash>& LruCache<K, V, Hash>::operator=( const LruCache<K, V, Hash>& other ) {
+    if (this != &other) {
+        _capacity = other._capacity;
+        _bytes = other._bytes;
+        _hits = other._hits;
+        _misses = other._misses;
+        _evictions = other._evictions;
+        _entries = other._entries;
+        reindex();
+    }
+    return *this;
+}
+
+template <typename K, typename V, typename Hash>
+V* LruCache<K, V, Hash>::find( const K& key ) {
+    auto pos = _index.find( key );
+    if (pos == _index.end()) {
+        _misses++;
+        return nullptr;
+    }
+    _hits++;
+    _entries.splice( _entries.begin(), _entries, pos->second );
+    return &pos->second->value;
+}
+
+template <typename K, typename V, typename Hash>
+bool LruCache<K, V, Hash>::contains( const K& key ) const {
+    return _index.find( key ) != _index.end();
+}
+
+template <typename K, typename V, typename Hash>
+V& LruCache<K, V, Hash>::insert( const K& key, V&& value, const size_t bytes ) {
+    erase( key );
+    _entries.push_front( Entry { key, std::move( value ), bytes + ENTRY_OVERHEAD } );
+    _index[key] = _entries.begin();
+    _bytes += bytes + ENTRY_OVERHEAD;
+    evict(1);
+    return _entries.front().value;
+}
+
+template <typename K, typename V, typename Hash>
+bool LruCache<K, V, Hash>::erase( const K& key ) {
+    auto pos = _index.find( key );
+    if (pos == _index.end()) {
+        return false;
+    }
+    _bytes -= pos->second->bytes;
+    _entries.erase( pos->second );
+    _index.erase( pos );
+    return true;
+}
+
+template <typename K, typename V, typename Hash>
+void LruCache<K, V, Hash>::clear() {
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+}
+
+template <typename K, typename V, typename Hash>
+void LruCache<K, V, Hash>::setCapacity( const size_t capacity ) {
+    _capacity = capacity;
+    evict(0);
+}
+
+// drops the coldest entries until the capacity is respected, except for keep most recent ones
+template <typename K, typename V, typename Hash>
+void LruCache<K, V, Hash>::evict( const size_t keep ) {
+    while (_bytes > _capacity && _entries.size() > keep) {
+        auto& coldest = _entries.back();
+        _bytes -= coldest.bytes;
+        _index.erase( coldest.key );
+        _entries.pop_back();
+        _evictions++;
+    }
+}
+
+template <typename K, typename V, typename Hash>
+void LruCache<K, V, Hash>::reindex() {
+    _index.clear();
+    for (auto pos = _entries.begin(); pos != _entries.end(); pos++) {
+        _index[pos->key] = pos;
+    }
+}
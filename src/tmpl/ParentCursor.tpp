@@ -0,0 +1,95 @@
+template <typename T>
+ParentCursor<T>::ParentCursor()
+: _parent(), _consumer( 0 ) {}
+
+template <typename T>
+ParentCursor<T>::ParentCursor( SharedPtr<LazySequence<T>> parent )
+: _parent( parent ), _consumer( 0 ) {
+    attach( 0 );
+}
+
+template <typename T>
+ParentCursor<T>::ParentCursor( const ParentCursor<T>& other )
+: _parent( other._parent ), _consumer( 0 ) {
+    attach( other._parent ? other.getPosition() : 0 );
+}
+
+template <typename T>
+ParentCursor<T>& ParentCursor<T>::operator=( const ParentCursor<T>& other ) {
+    if (this != &other) {
+        detach();
+        _parent = other._parent;
+        attach( other._parent ? other.getPosition() : 0 );
+    }
+    return *this;
+}
+
+template <typename T>
+ParentCursor<T>::ParentCursor( ParentCursor<T>&& other )
+: _parent( std::move( other._parent )), _consumer( other._consumer ) {
+    other._parent = SharedPtr<LazySequence<T>>();
+}
+
+template <typename T>
+ParentCursor<T>& ParentCursor<T>::operator=( ParentCursor<T>&& other ) {
+    if (this != &other) {
+        detach();
+        _parent = std::move( other._parent );
+        _consumer = other._consumer;
+        other._parent = SharedPtr<LazySequence<T>>();
+    }
+    return *this;
+}
+
+template <typename T>
+ParentCursor<T>::~ParentCursor() {
+    detach();
+}
+
+template <typename T>
+void ParentCursor<T>::attach( const size_t position ) {
+    if (_parent) {
+        _consumer = _parent->attachConsumer( position );
+    }
+}
+
+template <typename T>
+void ParentCursor<T>::detach() {
+    if (_parent) {
+        _parent->detachConsumer( _consumer );
+        _parent = SharedPtr<LazySequence<T>>();
+    }
+}
+
+template <typename T>
+T ParentCursor<T>::next() {
+    return _parent->readNext( _consumer );
+}
+
+template <typename T>
+bool ParentCursor<T>::hasNext() {
+    return _parent->canReadNext( _consumer );
+}
+
+template <typename T>
+ScanStatus ParentCursor<T>::scan( const Option<ScanBudget>& budget ) {
+    return getPosition() < _parent->getMaterializedCount() ? ScanStatus::FOUND : _parent->scanNext( budget );
+}
+
+template <typename T>
+size_t ParentCursor<T>::getPosition() const {
+    return (*this)->_consumers[_consumer];
+}
+
+template <typename T>
+void ParentCursor<T>::saveState( SnapshotWriter& out ) const {
+    out.write( getPosition() );
+    _parent->saveState( out );
+}
+
+template <typename T>
+void ParentCursor<T>::restoreState( SnapshotReader& in ) {
+    size_t position = in.read<size_t>();
+    _parent->_consumers[_consumer] = position;
+    _parent->restoreState( in );
+}
@@ -0,0 +1,183 @@
+#include <cstdio>
+
+// pipelines are small, a linear search is cheaper than hashing here
+inline bool PipelineVisitor::markVisited( const void* node ) {
+    for (size_t index = 0; index < _visited.getSize(); index++) {
+        if (_visited[index] == node) {
+            return false;
+        }
+    }
+    _visited.append( node );
+    return true;
+}
+
+template <typename U>
+void PipelineVisitor::visit( const SharedPtr<LazySequence<U>>& seq ) {
+    if (seq.operator->() != nullptr) {
+        visit( *seq );
+    }
+}
+
+inline void PipelinePlan::onNode( const PipelineNode& node ) {
+    _nodes.append( node );
+}
+
+inline void PipelinePlan::onEdge( const void* child, const void* parent ) {
+    _edgesFrom.append( child );
+    _edgesTo.append( parent );
+}
+
+inline size_t PipelinePlan::indexOf( const void* id ) const {
+    for (size_t index = 0; index < _nodes.getSize(); index++) {
+        if (_nodes[index].id == id) {
+            return index;
+        }
+    }
+    throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+}
+
+inline double PipelinePlan::pullCost( const size_t index, ArraySequence<double>& costs ) const {
+    if (costs[index] >= 0.0) {
+        return costs[index];
+    }
+    double worstParent = 0.0;
+    for (size_t edge = 0; edge < _edgesFrom.getSize(); edge++) {
+        if (_edgesFrom[edge] == _nodes[index].id) {
+            double parent = pullCost( indexOf( _edgesTo[edge] ), costs );
+            worstParent = parent > worstParent ? parent : worstParent;
+        }
+    }
+    costs[index] = 1.0 + _nodes[index].pullFactor * worstParent;
+    return costs[index];
+}
+
+inline ArraySequence<double> PipelinePlan::getPullCosts() const {
+    ArraySequence<double> costs;
+    for (size_t node = 0; node < _nodes.getSize(); node++) {
+        costs.append( -1.0 );
+    }
+    for (size_t node = 0; node < _nodes.getSize(); node++) {
+        pullCost( node, costs );
+    }
+    return costs;
+}
+
+inline size_t PipelinePlan::depth( const size_t index, ArraySequence<size_t>& depths ) const {
+    if (depths[index] != 0) {
+        return depths[index];
+    }
+    size_t deepestParent = 0;
+    for (size_t edge = 0; edge < _edgesFrom.getSize(); edge++) {
+        if (_edgesFrom[edge] == _nodes[index].id) {
+            size_t parent = depth( indexOf( _edgesTo[edge] ), depths );
+            deepestParent = parent > deepestParent ? parent : deepestParent;
+        }
+    }
+    depths[index] = 1 + deepestParent;
+    return depths[index];
+}
+
+inline size_t PipelinePlan::getDepth() const {
+    if (_nodes.isEmpty()) {
+        return 0;
+    }
+    ArraySequence<size_t> depths;
+    for (size_t node = 0; node < _nodes.getSize(); node++) {
+        depths.append( 0 );
+    }
+    return depth( 0, depths ); // the visited sequence is reported first
+}
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+inline ArraySequence<size_t> PipelinePlan::getSelfNanoseconds() const {
+    ArraySequence<size_t> children;
+    for (size_t node = 0; node < _nodes.getSize(); node++) {
+        children.append( 0 );
+    }
+    for (size_t edge = 0; edge < _edgesTo.getSize(); edge++) {
+        children[indexOf( _edgesTo[edge] )]++;
+    }
+    ArraySequence<size_t> self;
+    for (size_t node = 0; node < _nodes.getSize(); node++) {
+        size_t inParents = 0;
+        for (size_t edge = 0; edge < _edgesFrom.getSize(); edge++) {
+            if (_edgesFrom[edge] == _nodes[node].id) {
+                size_t parent = indexOf( _edgesTo[edge] );
+                inParents += _nodes[parent].counters.nanoseconds / children[parent];
+            }
+        }
+        size_t total = _nodes[node].counters.nanoseconds;
+        self.append( total > inParents ? total - inParents : 0 );
+    }
+    return self;
+}
+#endif
+
+inline std::string escapePipelineString( const std::string& value ) {
+    std::string res;
+    for (char symbol : value) {
+        if (symbol == '"' || symbol == '\\') {
+            res.push_back( '\\' );
+        }
+        res.push_back( symbol );
+    }
+    return res;
+}
+
+inline std::string formatPipelineNumber( const double value ) {
+    char number[32];
+    std::snprintf( number, sizeof(number), "%.2f", value );
+    return number;
+}
+
+inline std::string PipelinePlan::render( const ExplainFormat format ) const {
+    return format == ExplainFormat::DOT ? renderDot() : renderJson();
+}
+
+inline std::string PipelinePlan::renderDot() const {
+    auto costs = getPullCosts();
+    std::string res = "digraph pipeline {\n    node [shape=box, fontname=\"monospace\"];\n";
+    for (size_t index = 0; index < _nodes.getSize(); index++) {
+        const PipelineNode& node = _nodes[index];
+        res += "    n" + std::to_string( index ) + " [label=\"" + escapePipelineString( node.generator )
+             + "\\nordinality: " + (node.ordinality.hasValue() ? node.ordinality.get().toString() : std::string( "unknown" ))
+             + "\\ncached: " + std::to_string( node.cached ) + " (" + std::to_string( node.cacheBytes ) + " B)"
+             + ", materialized: " + std::to_string( node.materialized )
+             + "\\npull cost: " + formatPipelineNumber( costs[index] ) + "\"];\n";
+    }
+    for (size_t edge = 0; edge < _edgesFrom.getSize(); edge++) {
+        res += "    n" + std::to_string( indexOf( _edgesFrom[edge] )) + " -> n" + std::to_string( indexOf( _edgesTo[edge] )) + ";\n";
+    }
+    return res + "}\n";
+}
+
+inline std::string PipelinePlan::renderJson() const {
+    auto costs = getPullCosts();
+    std::string res = "{\"nodes\":[";
+    for (size_t index = 0; index < _nodes.getSize(); index++) {
+        const PipelineNode& node = _nodes[index];
+        res += std::string( index == 0 ? "\n" : ",\n" )
+             + "{\"id\":" + std::to_string( index )
+             + ",\"generator\":\"" + escapePipelineString( node.generator ) + "\""
+             + ",\"ordinality\":" + (node.ordinality.hasValue() ? "\"" + node.ordinality.get().toString() + "\"" : std::string( "null" ))
+             + ",\"cached\":" + std::to_string( node.cached )
+             + ",\"cacheBytes\":" + std::to_string( node.cacheBytes )
+             + ",\"materialized\":" + std::to_string( node.materialized )
+             + ",\"pullFactor\":" + formatPipelineNumber( node.pullFactor )
+             + ",\"pullCost\":" + formatPipelineNumber( costs[index] ) + "}";
+    }
+    res += "\n],\"edges\":[";
+    for (size_t edge = 0; edge < _edgesFrom.getSize(); edge++) {
+        res += std::string( edge == 0 ? "\n" : ",\n" )
+             + "{\"from\":" + std::to_string( indexOf( _edgesFrom[edge] ))
+             + ",\"to\":" + std::to_string( indexOf( _edgesTo[edge] )) + "}";
+    }
+    return res + "\n]}\n";
+}
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+inline void CounterCollector::onNode( const PipelineNode& node ) {
+    _snapshot.counters += node.counters;
+    _snapshot.sequences++;
+}
+#endif
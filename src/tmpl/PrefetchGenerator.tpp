@@ -0,0 +1,151 @@
+template <typename T>
+PrefetchGenerator<T>::PrefetchGenerator( SharedPtr<IGenerator<T>> source, const size_t depth, const size_t first )
+: _source( source ), _sourceLock(), _ring( depth ), _worker(), _consumed( first ), _error() {}
+
+template <typename T>
+PrefetchGenerator<T>::~PrefetchGenerator() {
+    _ring.cancel();
+    if (_worker.joinable()) {
+        _worker.join();
+    }
+}
+
+template <typename T>
+T PrefetchGenerator<T>::getNext() {
+    LAZY_TRACE();
+    start();
+    T res;
+    if (!_ring.pop( res )) {
+        rethrow();
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    ++_consumed;
+    return res;
+}
+
+// the wrapped generator is ahead of the consumer, so it may have already dropped the elements waiting in the ring.
+// the worker pushes under the lock, so every element taken from the wrapped generator is found in the ring here
+template <typename T>
+T PrefetchGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    if (index.isFinite() && _consumed <= index) {
+        T res;
+        if (_ring.peek( static_cast<size_t>( index ) - _consumed, res )) {
+            return res;
+        }
+    }
+    return _source->get( index );
+}
+
+template <typename T>
+bool PrefetchGenerator<T>::hasNext() {
+    start();
+    if (_ring.waitForValue()) {
+        return true;
+    }
+    rethrow();
+    return false;
+}
+
+// a bounded budget isn't spent waiting: the worker scans on its own, the caller comes back for what it has found
+template <typename T>
+ScanStatus PrefetchGenerator<T>::scan( const Option<ScanBudget>& budget ) {
+    if (!budget.hasValue() || !budget.get().isBounded()) {
+        return hasNext() ? ScanStatus::FOUND : ScanStatus::FINISHED;
+    }
+    start();
+    bool isClosed = _ring.isClosed(); // read first, the values pushed before closing are counted below
+    if (_ring.getSize() > 0) {
+        return ScanStatus::FOUND;
+    }
+    if (isClosed) {
+        rethrow();
+        return ScanStatus::FINISHED;
+    }
+    return ScanStatus::BUDGET_EXHAUSTED;
+}
+
+template <typename T>
+Option<T> PrefetchGenerator<T>::tryGetNext() {
+    if (hasNext()) {
+        return Option<T>( getNext() );
+    } else {
+        return Option<T>();
+    }
+}
+
+template <typename T>
+std::string PrefetchGenerator<T>::getName() const {
+    return IGenerator<T>::getName() + "(" + _source->getName() + ")";
+}
+
+template <typename T>
+void PrefetchGenerator<T>::visitParents( PipelineVisitor& visitor ) const {
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    _source->visitParents( visitor );
+}
+
+template <typename T>
+Option<Ordinal> PrefetchGenerator<T>::getOrdinality() const {
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    return _source->getOrdinality();
+}
+
+template <typename T>
+double PrefetchGenerator<T>::getPullFactor() const {
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    return _source->getPullFactor();
+}
+
+template <typename T>
+size_t PrefetchGenerator<T>::getStateBytes() const {
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    return _ring.getCapacity() * sizeof(T) + _source->getStateBytes();
+}
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+template <typename T>
+void PrefetchGenerator<T>::addCounters( SequenceCounters& total ) const {
+    IGenerator<T>::addCounters( total );
+    std::lock_guard<std::mutex> guard( _sourceLock );
+    _source->addCounters( total );
+}
+#endif
+
+template <typename T>
+void PrefetchGenerator<T>::start() {
+    if (!_worker.joinable() && !_ring.isClosed()) {
+        _worker = std::thread( &PrefetchGenerator<T>::produce, this );
+    }
+}
+
+// the lock is held for a single element, so get() is never blocked for longer than one step of the source.
+// the space is awaited before taking the lock, so the push under it never blocks.
+// an exhausted scan budget of a where up the pipeline only releases the lock, the scan is resumed right away
+template <typename T>
+void PrefetchGenerator<T>::produce() {
+    try {
+        while (_ring.waitForSpace()) {
+            std::lock_guard<std::mutex> guard( _sourceLock );
+            ScanStatus status = _source->scan( Option<ScanBudget>() );
+            if (status == ScanStatus::FINISHED) {
+                break;
+            }
+            if (status == ScanStatus::FOUND && !_ring.push( _source->getNext() )) {
+                break;
+            }
+        }
+    } catch ( ... ) {
+        _error = std::current_exception();
+    }
+    _ring.close();
+}
+
+// the error is published by closing the ring, which the consumer has observed at this point
+template <typename T>
+void PrefetchGenerator<T>::rethrow() {
+    if (_error) {
+        std::rethrow_exception( _error );
+    }
+}
@@ -0,0 +1,13 @@
+inline SequenceCounters& SequenceCounters::operator+=( const SequenceCounters& other ) {
+    generatorCalls         += other.generatorCalls;
+    cacheHits              += other.cacheHits;
+    cacheMisses            += other.cacheMisses;
+    trims                  += other.trims;
+    bytesTrimmed           += other.bytesTrimmed;
+    dematerializedAccesses += other.dematerializedAccesses;
+    replays                += other.replays;
+    whereRejections        += other.whereRejections;
+    spillReads             += other.spillReads;
+    nanoseconds            += other.nanoseconds;
+    return *this;
+}
@@ -0,0 +1,183 @@
+#include <array>
+#include <bit>
+#include <type_traits>
+
+static const uint32_t SNAPSHOT_MAGIC = 0x5153'5A4C; // "LZSQ"
+static const uint32_t SNAPSHOT_VERSION = 3; // 2: positions of the generators in their parents, 3: trimmed where positions
+
+template <typename V>
+void SnapshotCodec<V>::write( SnapshotWriter& out, const V& value ) {
+    (void)out;
+    (void)value;
+    throw Exception( Exception::ErrorCode::UNSUPPORTED_SNAPSHOT );
+}
+
+template <typename V>
+V SnapshotCodec<V>::read( SnapshotReader& in ) {
+    (void)in;
+    throw Exception( Exception::ErrorCode::UNSUPPORTED_SNAPSHOT );
+}
+
+inline void SnapshotWriter::writeHeader() {
+    write( SNAPSHOT_MAGIC );
+    write( SNAPSHOT_VERSION );
+}
+
+inline void SnapshotWriter::writeBytes( const void* data, const size_t count ) {
+    _out.write( static_cast<const char*>( data ), static_cast<std::streamsize>( count ));
+    if (!_out) {
+        throw Exception( "Error. Unable to write the snapshot." );
+    }
+}
+
+template <typename V>
+void SnapshotWriter::write( const V& value ) {
+    if constexpr (std::is_trivially_copyable_v<V>) {
+        writeBytes( &value, sizeof(V) );
+    } else {
+        SnapshotCodec<V>::write( *this, value );
+    }
+}
+
+inline SnapshotReader::SnapshotReader( std::istream& in ) : _in( in ), _end( -1 ) {
+    std::streampos here = _in.tellg();
+    if (here != std::streampos( -1 )) {
+        _in.seekg( 0, std::ios::end );
+        _end = _in.tellg();
+        _in.seekg( here );
+    }
+}
+
+inline void SnapshotReader::readHeader() {
+    if (read<uint32_t>() != SNAPSHOT_MAGIC || read<uint32_t>() != SNAPSHOT_VERSION) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+}
+
+inline void SnapshotReader::readBytes( void* data, const size_t count ) {
+    _in.read( static_cast<char*>( data ), static_cast<std::streamsize>( count ));
+    if (static_cast<size_t>( _in.gcount() ) != count) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+}
+
+inline void SnapshotReader::expectRemaining( const size_t count, const size_t itemBytes ) {
+    if (_end < 0 || count == 0) {
+        return;
+    }
+    std::streamoff here = _in.tellg();
+    if (here < 0 || here > _end) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+    if (itemBytes > static_cast<size_t>( _end - here ) / count) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+}
+
+// trivially copyable values are read into raw bytes, so they don't need to be default constructible.
+// a bool is checked to be 0 or 1, any other byte would be a value a bool can't hold
+template <typename V>
+V SnapshotReader::read() {
+    if constexpr (std::is_same_v<V, bool>) {
+        uint8_t byte = read<uint8_t>();
+        if (byte > 1) {
+            throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+        }
+        return byte == 1;
+    } else if constexpr (std::is_trivially_copyable_v<V>) {
+        std::array<unsigned char, sizeof(V)> bytes;
+        readBytes( bytes.data(), sizeof(V) );
+        return std::bit_cast<V>( bytes );
+    } else {
+        return SnapshotCodec<V>::read( *this );
+    }
+}
+
+template <typename V>
+void SnapshotReader::expect( const V& value ) {
+    if (!(read<V>() == value)) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+}
+
+inline void SnapshotCodec<std::string>::write( SnapshotWriter& out, const std::string& value ) {
+    out.write( value.size() );
+    out.writeBytes( value.data(), value.size() );
+}
+
+inline std::string SnapshotCodec<std::string>::read( SnapshotReader& in ) {
+    size_t size = in.read<size_t>();
+    in.expectRemaining( size, 1 );
+    std::string res( size, '\0' );
+    in.readBytes( res.data(), res.size() );
+    return res;
+}
+
+// finite ordinals are a single number, transfinite ones a list of (coefficient, exponent) terms
+inline void SnapshotCodec<Ordinal>::write( SnapshotWriter& out, const Ordinal& value ) {
+    out.write( value.isFinite() );
+    if (value.isFinite()) {
+        out.write( static_cast<size_t>( value ));
+        return;
+    }
+    const auto& terms = value._value.getT2();
+    out.write( terms.getSize() );
+    for (size_t i = 0; i < terms.getSize(); i++) {
+        out.write( terms[i]._coefficient );
+        out.write( terms[i]._exponent );
+    }
+}
+
+inline Ordinal SnapshotCodec<Ordinal>::read( SnapshotReader& in ) {
+    if (in.read<bool>()) {
+        return Ordinal( in.read<size_t>() );
+    }
+    Ordinal::transfinite terms;
+    size_t count = in.read<size_t>();
+    in.expectRemaining( count, 2 * sizeof(unsigned) );
+    for (size_t i = 0; i < count; i++) {
+        unsigned coefficient = in.read<unsigned>();
+        unsigned exponent = in.read<unsigned>();
+        terms.append( Ordinal::Term( coefficient, exponent ));
+    }
+    return Ordinal( terms );
+}
+
+template <typename V>
+void SnapshotCodec<Option<V>>::write( SnapshotWriter& out, const Option<V>& value ) {
+    out.write( value.hasValue() );
+    if (value.hasValue()) {
+        out.write( value.get() );
+    }
+}
+
+template <typename V>
+Option<V> SnapshotCodec<Option<V>>::read( SnapshotReader& in ) {
+    if (in.read<bool>()) {
+        return Option<V>( in.read<V>() );
+    }
+    return Option<V>();
+}
+
+template <typename V>
+void SnapshotCodec<ArraySequence<V>>::write( SnapshotWriter& out, const ArraySequence<V>& value ) {
+    out.write( value.getSize() );
+    if constexpr (std::is_trivially_copyable_v<V>) {
+        out.writeBytes( value.getData(), value.getSize() * sizeof(V) );
+    } else {
+        for (size_t i = 0; i < value.getSize(); i++) {
+            out.write( value[static_cast<int>(i)] );
+        }
+    }
+}
+
+template <typename V>
+ArraySequence<V> SnapshotCodec<ArraySequence<V>>::read( SnapshotReader& in ) {
+    ArraySequence<V> res;
+    size_t count = in.read<size_t>();
+    in.expectRemaining( count, std::is_trivially_copyable_v<V> ? sizeof(V) : 1 ); // nothing is stored in less than a byte
+    for (size_t i = 0; i < count; i++) {
+        res.append( in.read<V>() );
+    }
+    return res;
+}
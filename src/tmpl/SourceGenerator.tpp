@@ -0,0 +1,84 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+template <typename T>
+MappedFile<T>::MappedFile( const std::string& path ) : _map( nullptr ), _bytes(0) {
+    int fd = open( path.c_str(), O_RDONLY );
+    if (fd < 0) {
+        throw Exception( "Error. Unable to open the mapped file." );
+    }
+    struct stat info;
+    if (fstat( fd, &info ) != 0) {
+        close( fd );
+        throw Exception( "Error. Unable to open the mapped file." );
+    }
+    _bytes = static_cast<size_t>( info.st_size );
+    if (_bytes % sizeof(T) != 0) {
+        close( fd );
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    if (_bytes > 0) {
+        void* map = mmap( nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0 );
+        if (map == MAP_FAILED) {
+            close( fd );
+            throw Exception( "Error. Unable to map the file." );
+        }
+        _map = map;
+    }
+    close( fd ); // the mapping keeps the file open
+}
+
+template <typename T>
+MappedFile<T>::~MappedFile() {
+    if (_map != nullptr) {
+        munmap( _map, _bytes );
+    }
+}
+
+template <typename T>
+SourceGenerator<T>::SourceGenerator( SharedPtr<ContiguousSource<T>> source )
+: _source( source ), _data( source->getData() ), _size( source->getSize() ), _lastMaterialized(0) {}
+
+template <typename T>
+T SourceGenerator<T>::getNext() {
+    LAZY_TRACE();
+    if (!hasNext()) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
+    return _data[_lastMaterialized++];
+}
+
+template <typename T>
+T SourceGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
+    if (!index.isFinite() || static_cast<size_t>(index) >= _size) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return _data[static_cast<size_t>(index)];
+}
+
+template <typename T>
+bool SourceGenerator<T>::hasNext() {
+    return _lastMaterialized < _size;
+}
+
+template <typename T>
+Option<T> SourceGenerator<T>::tryGetNext() {
+    if (hasNext()) {
+        return Option<T>( getNext() );
+    } else {
+        return Option<T>();
+    }
+}
+
+template <typename T>
+void SourceGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _size );
+    out.write( _lastMaterialized );
+}
+
+template <typename T>
+void SourceGenerator<T>::restoreState( SnapshotReader& in ) {
+    in.expect( _size );
+    _lastMaterialized = in.read<size_t>();
+}
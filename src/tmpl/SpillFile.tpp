@@ -0,0 +1,98 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+
+template <typename T>
+SpillFile<T>::SpillFile( const size_t base, const std::string& directory )
+: _fd( -1 ), _base( base ), _count(0), _map( nullptr ), _mapped(0) {
+    static_assert( std::is_trivially_copyable_v<T>, "only trivially copyable elements can be spilled" );
+    std::string dir = directory;
+    if (dir.empty()) {
+        const char* tmp = std::getenv( "TMPDIR" );
+        dir = tmp != nullptr && *tmp != '\0' ? tmp : "/tmp";
+    }
+    std::string path = dir + "/lazy-sequence-spill-XXXXXX";
+    _fd = mkstemp( path.data() );
+    if (_fd < 0) {
+        throw Exception( "Error. Unable to create a spill file." );
+    }
+    unlink( path.c_str() );
+}
+
+template <typename T>
+SpillFile<T>::~SpillFile() {
+    if (_map != nullptr) {
+        munmap( _map, _mapped );
+    }
+    if (_fd >= 0) {
+        close( _fd );
+    }
+}
+
+template <typename T>
+void SpillFile<T>::append( const T* values, const size_t count ) {
+    const char* bytes = reinterpret_cast<const char*>( values );
+    size_t left = count * sizeof(T);
+    off_t offset = static_cast<off_t>( _count * sizeof(T) );
+    while (left > 0) {
+        ssize_t written = pwrite( _fd, bytes, left, offset );
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            throw Exception( "Error. Unable to write the spill file." );
+        }
+        bytes  += written;
+        left   -= static_cast<size_t>( written );
+        offset += written;
+    }
+    _count += count;
+}
+
+template <typename T>
+T SpillFile<T>::read( const size_t index ) {
+    if (!contains( index )) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    size_t position = (index - _base) * sizeof(T);
+    if (position + sizeof(T) > _mapped) {
+        remap();
+    }
+    T res;
+    std::memcpy( &res, static_cast<const char*>( _map ) + position, sizeof(T) );
+    return res;
+}
+
+template <typename T>
+void SpillFile<T>::clear( const size_t base ) {
+    if (_map != nullptr) {
+        munmap( _map, _mapped );
+        _map = nullptr;
+        _mapped = 0;
+    }
+    if (ftruncate( _fd, 0 ) != 0) {
+        throw Exception( "Error. Unable to truncate the spill file." );
+    }
+    _base = base;
+    _count = 0;
+}
+
+// the whole file is mapped, pages which haven't been touched for a while are dropped by the kernel
+template <typename T>
+void SpillFile<T>::remap() {
+    if (_map != nullptr) {
+        munmap( _map, _mapped );
+        _map = nullptr;
+        _mapped = 0;
+    }
+    void* map = mmap( nullptr, getBytes(), PROT_READ, MAP_SHARED, _fd, 0 );
+    if (map == MAP_FAILED) {
+        throw Exception( "Error. Unable to map the spill file." );
+    }
+    _map = map;
+    _mapped = getBytes();
+}
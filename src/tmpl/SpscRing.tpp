@@ -0,0 +1,119 @@
+#include <utility>
+
+template <typename T>
+SpscRing<T>::SpscRing( const size_t capacity )
+: _slots( nullptr ), _mask(0), _head(0), _tail(0)
+, _closed( false ), _cancelled( false ), _producerWaiting( false ), _consumerWaiting( false )
+, _producerEpoch(0), _consumerEpoch(0) {
+    if (capacity == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    _slots = new T[rounded];
+    _mask = rounded - 1;
+}
+
+template <typename T>
+SpscRing<T>::~SpscRing() {
+    delete[] _slots;
+}
+
+// the waiting flag is raised before the last check of the indices and the other side publishes its index
+// before looking at the flag. both are sequentially consistent, so at least one of the sides sees the other
+template <typename T>
+bool SpscRing<T>::waitForSpace() {
+    size_t tail = _tail.load( std::memory_order_relaxed );
+    while (tail - _head.load( std::memory_order_seq_cst ) > _mask) {
+        if (isCancelled()) {
+            return false;
+        }
+        auto epoch = _producerEpoch.load( std::memory_order_seq_cst );
+        _producerWaiting.store( true, std::memory_order_seq_cst );
+        if (tail - _head.load( std::memory_order_seq_cst ) > _mask && !isCancelled()) {
+            _producerEpoch.wait( epoch, std::memory_order_seq_cst );
+        }
+        _producerWaiting.store( false, std::memory_order_relaxed );
+    }
+    return !isCancelled();
+}
+
+template <typename T>
+bool SpscRing<T>::push( T&& value ) {
+    if (!waitForSpace()) {
+        return false;
+    }
+    size_t tail = _tail.load( std::memory_order_relaxed );
+    _slots[tail & _mask] = std::move( value );
+    _tail.store( tail + 1, std::memory_order_seq_cst );
+    wake( _consumerWaiting, _consumerEpoch );
+    return true;
+}
+
+template <typename T>
+void SpscRing<T>::close() {
+    _closed.store( true, std::memory_order_seq_cst );
+    wake( _consumerWaiting, _consumerEpoch );
+}
+
+template <typename T>
+bool SpscRing<T>::waitForValue() {
+    size_t head = _head.load( std::memory_order_relaxed );
+    while (head == _tail.load( std::memory_order_seq_cst )) {
+        // values pushed before closing are still to be read
+        if (isClosed()) {
+            return head != _tail.load( std::memory_order_seq_cst );
+        }
+        auto epoch = _consumerEpoch.load( std::memory_order_seq_cst );
+        _consumerWaiting.store( true, std::memory_order_seq_cst );
+        if (head == _tail.load( std::memory_order_seq_cst ) && !isClosed()) {
+            _consumerEpoch.wait( epoch, std::memory_order_seq_cst );
+        }
+        _consumerWaiting.store( false, std::memory_order_relaxed );
+    }
+    return true;
+}
+
+template <typename T>
+bool SpscRing<T>::pop( T& value ) {
+    if (!waitForValue()) {
+        return false;
+    }
+    size_t head = _head.load( std::memory_order_relaxed );
+    value = std::move( _slots[head & _mask] );
+    _head.store( head + 1, std::memory_order_seq_cst );
+    wake( _producerWaiting, _producerEpoch );
+    return true;
+}
+
+// the producer never writes the slots between the head and the tail, so they can be read in place
+template <typename T>
+bool SpscRing<T>::peek( const size_t offset, T& value ) const {
+    size_t head = _head.load( std::memory_order_relaxed );
+    if (offset >= _tail.load( std::memory_order_seq_cst ) - head) {
+        return false;
+    }
+    value = _slots[(head + offset) & _mask];
+    return true;
+}
+
+template <typename T>
+void SpscRing<T>::cancel() {
+    _cancelled.store( true, std::memory_order_seq_cst );
+    wake( _producerWaiting, _producerEpoch );
+}
+
+template <typename T>
+size_t SpscRing<T>::getSize() const {
+    return _tail.load( std::memory_order_acquire ) - _head.load( std::memory_order_acquire );
+}
+
+template <typename T>
+void SpscRing<T>::wake( std::atomic<bool>& waiting, std::atomic<uint32_t>& epoch ) {
+    if (waiting.load( std::memory_order_seq_cst )) {
+        epoch.fetch_add( 1, std::memory_order_seq_cst );
+        epoch.notify_one();
+    }
+}
@@ -0,0 +1,112 @@
+#include <charconv>
+
+template <typename T> requires std::is_arithmetic_v<T>
+TextGenerator<T>::TextGenerator( const std::string& path, const size_t blockSize )
+: _path( path ), _reader( path, blockSize ), _lastMaterialized(0)
+, _pending(), _hasPending( false ), _unparsed(), _hasUnparsed( false ), _isExhausted( false ) {}
+
+template <typename T> requires std::is_arithmetic_v<T>
+T TextGenerator<T>::getNext() {
+    LAZY_TRACE();
+    if (!hasNext()) { throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS ); }
+    _hasPending = false;
+    _lastMaterialized++;
+    return _pending;
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+T TextGenerator<T>::get( const Ordinal& index ) {
+    LAZY_TRACE();
+    if (!index.isFinite()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    LAZY_COUNT( replays, 1 );
+    TextReader reader( _path, _reader.getBlockSize() );
+    std::string_view token;
+    for (size_t i = 0; i <= static_cast<size_t>(index); i++) {
+        if (!reader.nextToken( token )) {
+            throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+        }
+    }
+    return parse( token );
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+bool TextGenerator<T>::hasNext() {
+    if (_hasPending) {
+        return true;
+    }
+    std::string_view token;
+    if (_hasUnparsed) {
+        token = _unparsed;
+    } else if (_isExhausted || !_reader.nextToken( token )) {
+        _isExhausted = true;
+        return false;
+    }
+    try {
+        _pending = parse( token );
+    } catch ( Exception& ) {
+        if (!_hasUnparsed) {
+            _unparsed.assign( token ); // the view is gone once the reader moves on
+            _hasUnparsed = true;
+        }
+        throw;
+    }
+    _hasUnparsed = false;
+    _hasPending = true;
+    return true;
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+Option<T> TextGenerator<T>::tryGetNext() {
+    if (hasNext()) {
+        return Option<T>( getNext() );
+    } else {
+        return Option<T>();
+    }
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+Option<Ordinal> TextGenerator<T>::getOrdinality() const {
+    if (_isExhausted) {
+        return Option<Ordinal>( _lastMaterialized );
+    }
+    return Option<Ordinal>();
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+size_t TextGenerator<T>::getStateBytes() const {
+    return _reader.getBlockSize();
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+void TextGenerator<T>::saveState( SnapshotWriter& out ) const {
+    out.write( _lastMaterialized );
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+void TextGenerator<T>::restoreState( SnapshotReader& in ) {
+    size_t count = in.read<size_t>();
+    while (_lastMaterialized < count) {
+        getNext();
+    }
+    if (_lastMaterialized != count) {
+        throw Exception( Exception::ErrorCode::SNAPSHOT_MISMATCH );
+    }
+}
+
+// a leading plus is accepted, from_chars doesn't
+template <typename T> requires std::is_arithmetic_v<T>
+T TextGenerator<T>::parse( const std::string_view& token ) {
+    const char* first = token.data();
+    const char* last = token.data() + token.size();
+    if (first != last && *first == '+') {
+        first++;
+    }
+    T res {};
+    auto [end, error] = std::from_chars( first, last, res );
+    if (error != std::errc() || end != last) {
+        throw Exception( Exception::ErrorCode::UNEXPECTED_CHAR );
+    }
+    return res;
+}
@@ -0,0 +1,132 @@
+#include <cstring>
+
+inline float* TileStorage<0>::allocate( const size_t size ) {
+    if (size == 0) {
+        return nullptr;
+    }
+    auto bytes = size * size * sizeof(float);
+    // keeps whole rows of aligned tiles aligned as well
+    bytes = (bytes + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+    return static_cast<float*>( ::operator new( bytes, std::align_val_t( TILE_ALIGNMENT )));
+}
+
+inline void TileStorage<0>::release( float* cells ) {
+    if (cells) {
+        ::operator delete( cells, std::align_val_t( TILE_ALIGNMENT ));
+    }
+}
+
+inline TileStorage<0>::TileStorage( const TileStorage<0>& other )
+: _cells( allocate( other._size )), _size( other._size ) {
+    if (_cells) {
+        std::memcpy( _cells, other._cells, _size * _size * sizeof(float) );
+    }
+}
+
+inline TileStorage<0>& TileStorage<0>::operator=( const TileStorage<0>& other ) {
+    if (this != &other) {
+        if (_size != other._size) {
+            release( _cells );
+            _cells = allocate( other._size );
+            _size = other._size;
+        }
+        if (_cells) {
+            std::memcpy( _cells, other._cells, _size * _size * sizeof(float) );
+        }
+    }
+    return *this;
+}
+
+inline TileStorage<0>::TileStorage( TileStorage<0>&& other )
+: _cells( other._cells ), _size( other._size ) {
+    other._cells = nullptr;
+    other._size = 0;
+}
+
+inline TileStorage<0>& TileStorage<0>::operator=( TileStorage<0>&& other ) {
+    if (this != &other) {
+        release( _cells );
+        _cells = other._cells;
+        _size = other._size;
+        other._cells = nullptr;
+        other._size = 0;
+    }
+    return *this;
+}
+
+inline TileStorage<0>::~TileStorage() {
+    release( _cells );
+}
+
+inline const float& TileColumn::operator[]( const size_t row ) const {
+    if (row >= _size) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return _cells[row * _size + _col];
+}
+
+inline TileColumn::operator ArraySequence<float>() const {
+    ArraySequence<float> res( static_cast<int>( _size ));
+    for (size_t row = 0; row < _size; row++) {
+        res.append( _cells[row * _size + _col] );
+    }
+    return res;
+}
+
+template <size_t N>
+Tile<N>::Tile( const size_t size, const float value ) : _storage( size ) {
+    auto cells = getData();
+    for (size_t index = 0; index < getCount(); index++) {
+        cells[index] = value;
+    }
+}
+
+template <size_t N>
+template <size_t M>
+Tile<N>::Tile( const Tile<M>& other ) : _storage( other.getSize() ) {
+    if (getCount() != 0) {
+        std::memcpy( getData(), other.getData(), getBytes() );
+    }
+}
+
+template <size_t N>
+float& Tile<N>::operator()( const size_t row, const size_t col ) {
+    if (row >= getSize() || col >= getSize()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return getData()[row * getSize() + col];
+}
+
+template <size_t N>
+const float& Tile<N>::operator()( const size_t row, const size_t col ) const {
+    if (row >= getSize() || col >= getSize()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return getData()[row * getSize() + col];
+}
+
+template <size_t N>
+TileColumn Tile<N>::operator[]( const size_t col ) const {
+    if (col >= getSize()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return TileColumn( getData(), col, getSize() );
+}
+
+template <size_t N>
+ArraySequence<float> Tile<N>::getRow( const size_t row ) const {
+    if (row >= getSize()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    ArraySequence<float> res( static_cast<int>( getSize() ));
+    auto cells = this->row( row );
+    for (size_t col = 0; col < getSize(); col++) {
+        res.append( cells[col] );
+    }
+    return res;
+}
+
+template <size_t N>
+ArraySequence<float> Tile<N>::getColumn( const size_t col ) const {
+    return (*this)[col];
+}
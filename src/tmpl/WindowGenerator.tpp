@@ -0,0 +1,199 @@
+template <typename T>
+WindowRing<T>::WindowRing( const size_t capacity )
+: _slots(), _head( 0 ), _size( 0 ) {
+    for (size_t index = 0; index < capacity; index++) {
+        _slots.append( T() );
+    }
+}
+
+template <typename T>
+void WindowRing<T>::pushBack( const T& value ) {
+    if (isFull()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    _slots[static_cast<int>( (_head + _size) % _slots.getSize() )] = value;
+    _size++;
+}
+
+template <typename T>
+T WindowRing<T>::popFront() {
+    if (isEmpty()) {
+        throw Exception( Exception::ErrorCode::EMPTY_STRUCTURE );
+    }
+    T res = _slots[static_cast<int>( _head )];
+    _head = (_head + 1) % _slots.getSize();
+    _size--;
+    return res;
+}
+
+template <typename T>
+void WindowRing<T>::popBack() {
+    if (isEmpty()) {
+        throw Exception( Exception::ErrorCode::EMPTY_STRUCTURE );
+    }
+    _size--;
+}
+
+template <typename T>
+const T& WindowRing<T>::front() const {
+    return (*this)[0];
+}
+
+template <typename T>
+const T& WindowRing<T>::back() const {
+    return (*this)[_size - 1];
+}
+
+template <typename T>
+const T& WindowRing<T>::operator[]( const size_t index ) const {
+    if (index >= _size) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    return _slots[static_cast<int>( (_head + index) % _slots.getSize() )];
+}
+
+template <typename T>
+ArraySequence<T> WindowRing<T>::toSequence() const {
+    ArraySequence<T> res;
+    for (size_t index = 0; index < _size; index++) {
+        res.append( (*this)[index] );
+    }
+    return res;
+}
+
+template <typename T>
+void WindowElements<T>::slide( const T& removed, const T& added, const WindowRing<T>& window ) {
+    (void)removed;
+    (void)added;
+    (void)window;
+}
+
+template <typename T> requires std::is_arithmetic_v<T>
+void RollingSum<T>::slide( const T& removed, const T& added, const WindowRing<T>& window ) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (++_slides >= window.getCapacity()) {
+            _sum = 0;
+            for (size_t index = 0; index < window.getSize(); index++) {
+                _sum += window[index];
+            }
+            _slides = 0;
+            return;
+        }
+    }
+    _sum += added;
+    _sum -= removed;
+}
+
+template <typename T, typename Compare>
+void RollingExtremum<T, Compare>::add( const T& value ) {
+    while (!_candidates.isEmpty() && _compare( value, _candidates.back() )) {
+        _candidates.popBack();
+    }
+    _candidates.pushBack( value );
+}
+
+template <typename T, typename Compare>
+void RollingExtremum<T, Compare>::slide( const T& removed, const T& added, const WindowRing<T>& window ) {
+    (void)window;
+    if (!_compare( _candidates.front(), removed ) && !_compare( removed, _candidates.front() )) {
+        _candidates.popFront();
+    }
+    add( added );
+}
+
+template <typename T, typename Aggregate>
+WindowGenerator<T, Aggregate>::WindowGenerator( SharedPtr<LazySequence<T>> parent, const size_t width )
+: _parent( parent ), _window( width ), _aggregate( width ), _emitted( 0 ) {}
+
+template <typename T, typename Aggregate>
+void WindowGenerator<T, Aggregate>::push( const T& value ) {
+    _window.pushBack( value );
+    _aggregate.add( value );
+}
+
+// the parent element is pulled before the window is touched, so a failed pull leaves the window as it was
+template <typename T, typename Aggregate>
+typename WindowGenerator<T, Aggregate>::Result WindowGenerator<T, Aggregate>::getNext() {
+    LAZY_TRACE();
+    if (_emitted == 0) {
+        while (!_window.isFull()) {
+            push( _parent.next() );
+        }
+    } else {
+        T added = _parent.next();
+        T removed = _window.popFront();
+        _window.pushBack( added );
+        _aggregate.slide( removed, added, _window );
+    }
+    _emitted++;
+    return _aggregate.get( _window );
+}
+
+template <typename T, typename Aggregate>
+typename WindowGenerator<T, Aggregate>::Result WindowGenerator<T, Aggregate>::get( const Ordinal& index ) {
+    LAZY_TRACE();
+    if (index.isTransfinite()) {
+        throw Exception( Exception::ErrorCode::UNKNOWN_ORDINALITY );
+    }
+    size_t start = static_cast<size_t>( index );
+    WindowRing<T> window( getWidth() );
+    Aggregate aggregate( getWidth() );
+    for (size_t offset = 0; offset < getWidth(); offset++) {
+        T value = _parent->get( Ordinal( start + offset ));
+        window.pushBack( value );
+        aggregate.add( value );
+    }
+    return aggregate.get( window );
+}
+
+// the first window is filled here, as a parent shorter than width is only found out by reading it
+template <typename T, typename Aggregate>
+bool WindowGenerator<T, Aggregate>::hasNext() {
+    if (_emitted == 0) {
+        while (!_window.isFull() && _parent.hasNext()) {
+            push( _parent.next() );
+        }
+        return _window.isFull();
+    }
+    return _parent.hasNext();
+}
+
+template <typename T, typename Aggregate>
+Option<typename WindowGenerator<T, Aggregate>::Result> WindowGenerator<T, Aggregate>::tryGetNext() {
+    if (hasNext()) {
+        return Option<Result>( getNext() );
+    } else {
+        return Option<Result>();
+    }
+}
+
+template <typename T, typename Aggregate>
+void WindowGenerator<T, Aggregate>::visitParents( PipelineVisitor& visitor ) const {
+    visitor.visit( _parent.getSequence() );
+}
+
+template <typename T, typename Aggregate>
+size_t WindowGenerator<T, Aggregate>::getStateBytes() const {
+    return _window.getCapacity() * sizeof(T) + _aggregate.getStateBytes();
+}
+
+template <typename T, typename Aggregate>
+void WindowGenerator<T, Aggregate>::saveState( SnapshotWriter& out ) const {
+    out.write( getWidth() );
+    out.write( _emitted );
+    out.write( _window.toSequence() );
+    _parent.saveState( out );
+}
+
+template <typename T, typename Aggregate>
+void WindowGenerator<T, Aggregate>::restoreState( SnapshotReader& in ) {
+    in.expect( getWidth() );
+    _emitted = in.read<size_t>();
+    ArraySequence<T> elements = in.read<ArraySequence<T>>();
+    _window = WindowRing<T>( getWidth() );
+    _aggregate = Aggregate( getWidth() );
+    for (size_t index = 0; index < elements.getSize(); index++) {
+        push( elements[static_cast<int>( index )] );
+    }
+    _parent.restoreState( in );
+}
@@ -1,16 +1,28 @@
 #include "mainwindow.hpp"
 #include "ui_mainwindow.h"
+#include <QMenu>
+#include <QMenuBar>
 
 MainWindow::MainWindow( QWidget* parent ) 
     : QMainWindow(parent)
     , ui( new Ui::MainWindow )
 {
     ui->setupUi(this);
+    seqModel = new SequenceModel(this);
+    ui->seqList->setModel(seqModel);
+    ui->seqList->setUniformItemSizes(true);
     ui->seqList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+    perfPanel = new PerfPanel(this);
+    addDockWidget(Qt::RightDockWidgetArea, perfPanel);
+    menuBar()->addMenu(tr("View"))->addAction(perfPanel->toggleViewAction());
+    connect( ui->seqList->selectionModel(), &QItemSelectionModel::currentChanged
+           , this, &MainWindow::onCurrentSequenceChanged );
 }
 
 MainWindow::~MainWindow()
 {
+    delete materializeTask;
     delete ui;
 }
 
@@ -20,9 +32,19 @@ void MainWindow::showError( const std::exception& ex ) {
 }
 
 void MainWindow::addToList( const SharedPtr<LazySequence<int>>& seq ) {
-    QListWidgetItem* item = new QListWidgetItem( contentsStr(seq) );
-    item->setData( Qt::UserRole, QVariant::fromValue(seq) );
-    ui->seqList->addItem(item);
+    seqModel->append(seq);
+}
+
+SharedPtr<LazySequence<int>> MainWindow::currentSequence() const {
+    return seqModel->sequenceAt( ui->seqList->currentIndex().row() );
+}
+
+QList<SharedPtr<LazySequence<int>>> MainWindow::selectedSequences() const {
+    QList<SharedPtr<LazySequence<int>>> res;
+    for ( const QModelIndex& index : ui->seqList->selectionModel()->selectedRows() ) {
+        res.append( seqModel->sequenceAt( index.row() ));
+    }
+    return res;
 }
 
 template <>
@@ -83,28 +105,18 @@ int MainWindow::getFromInput<int>( const QString& input ) const {
 void MainWindow::on_createBtn_clicked()
 {
     try {
-        auto* item = new QListWidgetItem();
         if (ui->recurRule->currentIndex() == Rule::None) {
-            item->setData( Qt::UserRole, QVariant::fromValue( LazySequence<int>::create() ));
+            addToList( LazySequence<int>::create() );
         } else if (ui->recurRule->currentIndex() == Rule::Natural) {
             auto data = ArraySequence<int>();
             data.append(1);
-            item->setData( Qt::UserRole, QVariant::fromValue(
-                             LazySequence<int>::create(1, MainWindow::NaturalRule(), data) 
-                                                             ));
+            addToList( LazySequence<int>::create(1, MainWindow::NaturalRule(), data) );
         } else {
             auto data = ArraySequence<int>();
             data.append(0);
             data.append(1);
-            item->setData( Qt::UserRole, QVariant::fromValue(
-                             LazySequence<int>::create(2, MainWindow::fibonacciRule(), data) 
-                                                             ));
+            addToList( LazySequence<int>::create(2, MainWindow::fibonacciRule(), data) );
         }
-        item->setText( 
-            contentsStr( item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>() )
-                     );
-                      
-        ui->seqList->addItem(item);
     } catch ( std::exception& ex ) {
         showError( Exception(ex) );
     }
@@ -113,12 +125,7 @@ void MainWindow::on_createBtn_clicked()
 void MainWindow::on_deleteBtn_clicked() 
 {
     try {
-        auto *item = ui->seqList->takeItem(ui->seqList->currentRow());
-        if (item) {
-            delete item;
-        } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-        }
+        seqModel->remove( ui->seqList->currentIndex().row() );
     } catch ( Exception& ex ) {
         showError( ex );
     }
@@ -127,32 +134,15 @@ void MainWindow::on_deleteBtn_clicked()
 void MainWindow::on_appendBtn_clicked()
 {
     try {
-        auto selected = ui->seqList->selectedItems();
+        auto selected = selectedSequences();
         if (selected.size() == 1) {
-            auto* item = selected[0];
-
-            if (item) {
-                auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                if (ui->valueInput->text().isEmpty()) {
-                    throw Exception( Exception::ErrorCode::INVALID_INPUT );
-                }
-
-                addToList( seq->append( getFromInput<int>( ui->valueInput->text() )));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            if (ui->valueInput->text().isEmpty()) {
+                throw Exception( Exception::ErrorCode::INVALID_INPUT );
             }
-        } else if (selected.size() == 2) {
-            auto* item1 = selected[0];
-            auto* item2 = selected[1];
 
-            if (item1 && item2) {
-                auto seq1 = item1->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                auto seq2 = item2->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-
-                addToList( seq1->append( *seq2 ) );
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-            }
+            addToList( selected[0]->append( getFromInput<int>( ui->valueInput->text() )));
+        } else if (selected.size() == 2) {
+            addToList( selected[0]->append( *selected[1] ) );
         } else {
             throw Exception( Exception::ErrorCode::INVALID_SELECTION );
         }
@@ -164,32 +154,15 @@ void MainWindow::on_appendBtn_clicked()
 void MainWindow::on_prependBtn_clicked()
 {
     try {
-        auto selected = ui->seqList->selectedItems();
+        auto selected = selectedSequences();
         if (selected.size() == 1) {
-            auto* item = selected[0];
-
-            if (item) {
-                auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                if (ui->valueInput->text().isEmpty()) {
-                    throw Exception( Exception::ErrorCode::INVALID_INPUT );
-                }
-
-                addToList( seq->prepend( getFromInput<int>( ui->valueInput->text() )));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            if (ui->valueInput->text().isEmpty()) {
+                throw Exception( Exception::ErrorCode::INVALID_INPUT );
             }
-        } else if (selected.size() == 2) {
-            auto* item1 = selected[0];
-            auto* item2 = selected[1];
-
-            if (item1 && item2) {
-                auto seq1 = item1->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                auto seq2 = item2->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
 
-                addToList( seq1->prepend( *seq2 ) );
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-            }
+            addToList( selected[0]->prepend( getFromInput<int>( ui->valueInput->text() )));
+        } else if (selected.size() == 2) {
+            addToList( selected[0]->prepend( *selected[1] ) );
         } else {
             throw Exception( Exception::ErrorCode::INVALID_SELECTION );
         }
@@ -201,16 +174,8 @@ void MainWindow::on_prependBtn_clicked()
 void MainWindow::on_memoiseBtn_clicked() 
 {
     try {
-        auto* item = ui->seqList->item( ui->seqList->currentRow());
-        if (item) {
-            auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-
-            seq->memoiseNext();
-
-            item->setText( contentsStr(seq) );
-        } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-        }
+        currentSequence()->memoiseNext();
+        seqModel->refresh();
     } catch ( Exception& ex ) {
         showError( ex );
     }
@@ -219,36 +184,19 @@ void MainWindow::on_memoiseBtn_clicked()
 void MainWindow::on_insertAtBtn_clicked()
 {
     try {
-        auto selected = ui->seqList->selectedItems();
+        auto selected = selectedSequences();
         if (selected.size() == 1) {
-            auto* item = selected[0];
-
-            if (item) {
-                auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                if (ui->valueInput->text().isEmpty() || ui->index1Input->text().isEmpty()) {
-                    throw Exception( Exception::ErrorCode::INVALID_INPUT );
-                }
+            if (ui->valueInput->text().isEmpty() || ui->index1Input->text().isEmpty()) {
+                throw Exception( Exception::ErrorCode::INVALID_INPUT );
+            }
 
-                addToList( seq->insertAt( 
+            addToList( selected[0]->insertAt( 
         getFromInput<int>( ui->valueInput->text()), getFromInput<Ordinal>( ui->index1Input->text()) 
-                                         ));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-            }
+                                            ));
         } else if (selected.size() == 2) {
-            auto* item1 = selected[0];
-            auto* item2 = selected[1];
-
-            if (item1 && item2) {
-                auto seq1 = item1->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-                auto seq2 = item2->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-
-                addToList( seq1->insertAt( 
-                    *seq2, getFromInput<Ordinal>( ui->index1Input->text()) 
-                                         ));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-            }
+            addToList( selected[0]->insertAt( 
+                *selected[1], getFromInput<Ordinal>( ui->index1Input->text()) 
+                                            ));
         } else {
             throw Exception( Exception::ErrorCode::INVALID_SELECTION );
         }
@@ -260,22 +208,12 @@ void MainWindow::on_insertAtBtn_clicked()
 void MainWindow::on_concatBtn_clicked() 
 {
     try {
-        auto selected = ui->seqList->selectedItems();
+        auto selected = selectedSequences();
         if (selected.size() != 2) {
             throw Exception( Exception::ErrorCode::INVALID_SELECTION );
         }
 
-        auto* item1 = selected[0];
-        auto* item2 = selected[1];
-
-        if (item1 && item2) {
-            auto seq1 = item1->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-            auto seq2 = item2->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-
-            addToList( seq1->concat( *seq2 ) );
-        } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
-        }
+        addToList( selected[0]->concat( *selected[1] ) );
     } catch ( Exception& ex ) {
         showError( ex );
     }
@@ -284,23 +222,18 @@ void MainWindow::on_concatBtn_clicked()
 void MainWindow::on_skipBtn_clicked() 
 {
     try {
-        auto* item = ui->seqList->item( ui->seqList->currentRow());
-        if (item) {
-            auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-            if (!ui->index1Input->text().isEmpty() && !ui->index1Input->text().isEmpty()) {
-                addToList(
-                    seq->skip( getFromInput<Ordinal>(ui->index1Input->text())
-                             , getFromInput<Ordinal>(ui->index2Input->text()))
-                          );
-            } else if (!ui->index1Input->text().isEmpty()) {
-                addToList(
-                    seq->skip( getFromInput<Ordinal>(ui->index1Input->text()))
-                          );
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_INPUT );
-            }
+        auto seq = currentSequence();
+        if (!ui->index1Input->text().isEmpty() && !ui->index1Input->text().isEmpty()) {
+            addToList(
+                seq->skip( getFromInput<Ordinal>(ui->index1Input->text())
+                         , getFromInput<Ordinal>(ui->index2Input->text()))
+                      );
+        } else if (!ui->index1Input->text().isEmpty()) {
+            addToList(
+                seq->skip( getFromInput<Ordinal>(ui->index1Input->text()))
+                      );
         } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
         }
     } catch ( Exception& ex ) {
         showError( ex );
@@ -310,19 +243,14 @@ void MainWindow::on_skipBtn_clicked()
 void MainWindow::on_subSeqBtn_clicked() 
 {
     try {
-        auto* item = ui->seqList->item( ui->seqList->currentRow());
-        if (item) {
-            auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-            if (!ui->index1Input->text().isEmpty() && !ui->index1Input->text().isEmpty()) {
-                addToList(
-        seq->getSubSequence( getFromInput<Ordinal>(ui->index1Input->text())
-                           , getFromInput<Ordinal>(ui->index2Input->text()))
-                          );
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_INPUT );
-            }
+        auto seq = currentSequence();
+        if (!ui->index1Input->text().isEmpty() && !ui->index1Input->text().isEmpty()) {
+            addToList(
+    seq->getSubSequence( getFromInput<Ordinal>(ui->index1Input->text())
+                       , getFromInput<Ordinal>(ui->index2Input->text()))
+                      );
         } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
         }
     } catch ( Exception& ex ) {
         showError( ex );
@@ -332,18 +260,13 @@ void MainWindow::on_subSeqBtn_clicked()
 void MainWindow::on_mapBtn_clicked() 
 {
     try {
-        auto* item = ui->seqList->item( ui->seqList->currentRow());
-        if (item) {
-            auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-            if (ui->mapFunc->currentIndex() == 0) {
-                addToList( seq->map<int>( MainWindow::mapDouble() ));
-            } else if (ui->mapFunc->currentIndex() == 1) {
-                addToList( seq->map<int>( MainWindow::mapSign() ));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_INPUT );
-            }
+        auto seq = currentSequence();
+        if (ui->mapFunc->currentIndex() == 0) {
+            addToList( seq->map<int>( MainWindow::mapDouble() ));
+        } else if (ui->mapFunc->currentIndex() == 1) {
+            addToList( seq->map<int>( MainWindow::mapSign() ));
         } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
         }
     } catch ( Exception& ex ) {
         showError( ex );
@@ -353,18 +276,99 @@ void MainWindow::on_mapBtn_clicked()
 void MainWindow::on_whereBtn_clicked() 
 {
     try {
-        auto* item = ui->seqList->item( ui->seqList->currentRow());
-        if (item) {
-            auto seq = item->data(Qt::UserRole).value<SharedPtr<LazySequence<int>>>();
-            if (ui->whereFunc->currentIndex() == 0) {
-                addToList( seq->where( MainWindow::whereEven() ));
-            } else {
-                throw Exception( Exception::ErrorCode::INVALID_INPUT );
-            }
+        auto seq = currentSequence();
+        if (ui->whereFunc->currentIndex() == 0) {
+            addToList( seq->where( MainWindow::whereEven(), MainWindow::interactiveBudget() ));
         } else {
-            throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
+        }
+    } catch ( Exception& ex ) {
+        showError( ex );
+    }
+}
+
+void MainWindow::on_materializeBtn_clicked() 
+{
+    try {
+        auto seq = currentSequence();
+        if (ui->countInput->text().isEmpty()) {
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
         }
+        int count = getFromInput<int>( ui->countInput->text() );
+        if (count <= 0) {
+            throw Exception( Exception::ErrorCode::INVALID_INPUT );
+        }
+
+        materializeTask = new MaterializeTask( seq, static_cast<size_t>(count) );
+        connect( materializeTask, &MaterializeTask::progress, this, &MainWindow::onMaterializeProgress );
+        connect( materializeTask, &MaterializeTask::finished, this, &MainWindow::onMaterializeFinished );
+        connect( materializeTask, &MaterializeTask::failed, this, &MainWindow::onMaterializeFailed );
+
+        ui->materializeProgress->setRange( 0, count );
+        ui->materializeProgress->setValue( 0 );
+        setBusy( true );
+        materializeTask->start();
     } catch ( Exception& ex ) {
         showError( ex );
     }
-}
\ No newline at end of file
+}
+
+void MainWindow::on_cancelBtn_clicked() 
+{
+    if (materializeTask) {
+        materializeTask->cancel();
+    }
+}
+
+void MainWindow::onMaterializeProgress( qulonglong done, qulonglong total ) 
+{
+    (void)total;
+    ui->materializeProgress->setValue( static_cast<int>(done) );
+    perfPanel->reportProgress( static_cast<size_t>(done) );
+}
+
+void MainWindow::onMaterializeFinished( qulonglong done, bool isCancelled ) 
+{
+    QString message = isCancelled 
+                    ? tr("Cancelled after %1 elements").arg(done) 
+                    : tr("Materialized %1 elements").arg(done);
+    statusBar()->showMessage( message, 5000 );
+    endMaterialize();
+}
+
+void MainWindow::onMaterializeFailed( QString message ) 
+{
+    statusBar()->showMessage( message, 5000 );
+    endMaterialize();
+}
+
+void MainWindow::endMaterialize() {
+    materializeTask->deleteLater();
+    materializeTask = nullptr;
+    setBusy( false );
+    onCurrentSequenceChanged(); // the selection may have moved while the panel was frozen
+}
+
+// SharedPtr copies aren't safe while a task runs, so the panel keeps the sequence it had until the task ends
+void MainWindow::onCurrentSequenceChanged() 
+{
+    if (materializeTask) {
+        return;
+    }
+    const QModelIndex current = ui->seqList->currentIndex();
+    perfPanel->setSequence( current.isValid() ? seqModel->sequenceAt( current.row() ) 
+                                              : SharedPtr<LazySequence<int>>() );
+}
+
+void MainWindow::setBusy( const bool isBusy ) {
+    const QList<QWidget*> actions = { 
+        ui->createBtn, ui->deleteBtn, ui->appendBtn, ui->prependBtn, ui->insertAtBtn, ui->concatBtn
+      , ui->skipBtn, ui->subSeqBtn, ui->mapBtn, ui->whereBtn, ui->memoiseBtn, ui->materializeBtn 
+    };
+    for ( QWidget* action : actions ) {
+        action->setEnabled( !isBusy );
+    }
+    ui->cancelBtn->setEnabled( isBusy );
+    seqModel->setFrozen( isBusy );
+    perfPanel->setFrozen( isBusy );
+}
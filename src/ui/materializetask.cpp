@@ -0,0 +1,61 @@
+#include "materializetask.hpp"
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent/QtConcurrentRun>
+
+MaterializeTask::MaterializeTask( const SharedPtr<LazySequence<int>>& seq, const size_t count, QObject* parent ) 
+    : QObject(parent)
+    , _seq( seq )
+    , _count( count )
+    , _isCancelled( false )
+{}
+
+MaterializeTask::~MaterializeTask() {
+    cancel();
+    _future.waitForFinished();
+}
+
+void MaterializeTask::start() {
+    _future = QtConcurrent::run( QThreadPool::globalInstance(), [this]() { run(); } );
+}
+
+void MaterializeTask::cancel() {
+    _isCancelled.store( true, std::memory_order_relaxed );
+}
+
+bool MaterializeTask::isRunning() const {
+    return _future.isRunning();
+}
+
+// a where running out of its scan budget is only paused, so the worker resumes it instead of giving up.
+// its scan is also limited to the progress interval, so a sparse where doesn't hold back progress and cancellation
+void MaterializeTask::run() {
+    QElapsedTimer timer;
+    timer.start();
+    size_t done = 0;
+    bool isFinished = false;
+    ScanBudget budget( std::chrono::milliseconds( PROGRESS_INTERVAL_MS ));
+    try {
+        while (done < _count && !isFinished && !_isCancelled.load( std::memory_order_relaxed )) {
+            switch (_seq->tryMemoiseNext( budget )) {
+                case ScanStatus::FOUND:
+                    done++;
+                    break;
+                case ScanStatus::FINISHED:
+                    isFinished = true;
+                    break;
+                case ScanStatus::BUDGET_EXHAUSTED:
+                    break;
+            }
+            if (timer.elapsed() >= PROGRESS_INTERVAL_MS) {
+                emit progress( done, _count );
+                timer.restart();
+            }
+        }
+    } catch ( std::exception& ex ) {
+        emit failed( QString( ex.what() ));
+        return;
+    }
+    emit progress( done, _count );
+    emit finished( done, _isCancelled.load( std::memory_order_relaxed ));
+}
@@ -0,0 +1,144 @@
+#include "perfpanel.hpp"
+#include <QFormLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+PerfPanel::PerfPanel( QWidget* parent )
+    : QDockWidget(tr("Performance"), parent)
+    , _seq()
+    , _timer( new QTimer(this) )
+    , _clock()
+    , _lastCount()
+    , _progress( 0 )
+    , _isFrozen( false )
+    , _rate( new QLabel(this) )
+    , _cache( new QLabel(this) )
+    , _trims( new QLabel(this) )
+    , _depth( new QLabel(this) )
+    , _stages( new QTableWidget(this) )
+{
+    setObjectName("perfPanel");
+
+#ifdef LAZY_SEQUENCE_COUNTERS
+    const QStringList columns = { tr("Stage"), tr("Materialized"), tr("Cached"), tr("Calls"), tr("Self time, ms") };
+#else
+    const QStringList columns = { tr("Stage"), tr("Materialized"), tr("Cached") };
+#endif
+    _stages->setColumnCount( columns.size() );
+    _stages->setHorizontalHeaderLabels( columns );
+    _stages->setEditTriggers( QAbstractItemView::NoEditTriggers );
+    _stages->setSelectionMode( QAbstractItemView::NoSelection );
+    _stages->verticalHeader()->setVisible( false );
+    _stages->horizontalHeader()->setSectionResizeMode( 0, QHeaderView::Stretch );
+
+    QWidget* contents = new QWidget(this);
+    QFormLayout* figures = new QFormLayout();
+    figures->addRow( tr("Rate:"), _rate );
+    figures->addRow( tr("Cache:"), _cache );
+    figures->addRow( tr("Trims:"), _trims );
+    figures->addRow( tr("Chain depth:"), _depth );
+    QVBoxLayout* layout = new QVBoxLayout(contents);
+    layout->addLayout( figures );
+    layout->addWidget( _stages );
+    setWidget( contents );
+    clear();
+
+    connect( _timer, &QTimer::timeout, this, &PerfPanel::sample );
+    _clock.start();
+    _timer->start( REFRESH_INTERVAL_MS );
+}
+
+void PerfPanel::setSequence( const SharedPtr<LazySequence<int>>& seq ) {
+    _seq = seq;
+    _lastCount = Option<size_t>();
+    sample();
+}
+
+// the count the rate is computed from changes its source, so the next sample only takes a baseline
+void PerfPanel::setFrozen( const bool isFrozen ) {
+    _isFrozen = isFrozen;
+    _progress = 0;
+    _lastCount = Option<size_t>();
+    sample();
+}
+
+bool PerfPanel::isFrozen() const {
+    return _isFrozen;
+}
+
+void PerfPanel::reportProgress( const size_t done ) {
+    _progress = done;
+}
+
+void PerfPanel::sample() {
+    if (_isFrozen) {
+        showRate( _progress );
+        return;
+    }
+    if (!_seq) {
+        clear();
+        return;
+    }
+
+    PipelinePlan plan;
+    plan.visit( _seq );
+    const PipelineNode& own = plan.getNode( 0 );
+    showRate( own.materialized );
+    _cache->setText( tr("%1 elements, %2").arg( own.cached ).arg( formatBytes( own.cacheBytes )));
+#ifdef LAZY_SEQUENCE_COUNTERS
+    _trims->setText( tr("%1, %2 dropped").arg( own.counters.trims ).arg( formatBytes( own.counters.bytesTrimmed )));
+#else
+    _trims->setText( tr("n/a, built without counters") );
+#endif
+    _depth->setText( QString::number( plan.getDepth() ));
+    showStages( plan );
+}
+
+// one row per sequence in the order of the visit, so the selected one comes first and its sources last.
+// the time of a stage leaves out the time spent in the stages it pulls from, see PipelinePlan::getSelfNanoseconds()
+void PerfPanel::showStages( const PipelinePlan& plan ) {
+    _stages->setRowCount( static_cast<int>(plan.getNodeCount()) );
+#ifdef LAZY_SEQUENCE_COUNTERS
+    const ArraySequence<size_t> self = plan.getSelfNanoseconds();
+#endif
+    for (size_t index = 0; index < plan.getNodeCount(); index++) {
+        const PipelineNode& node = plan.getNode( index );
+        const int row = static_cast<int>(index);
+        _stages->setItem( row, 0, new QTableWidgetItem( QString::fromStdString( node.generator )));
+        _stages->setItem( row, 1, new QTableWidgetItem( QString::number( node.materialized )));
+        _stages->setItem( row, 2, new QTableWidgetItem( QString::number( node.cached )));
+#ifdef LAZY_SEQUENCE_COUNTERS
+        _stages->setItem( row, 3, new QTableWidgetItem( QString::number( node.counters.generatorCalls )));
+        _stages->setItem( row, 4, new QTableWidgetItem( QString::number( self[index] / 1e6, 'f', 1 )));
+#endif
+    }
+}
+
+void PerfPanel::showRate( const size_t count ) {
+    const qint64 elapsed = _clock.restart();
+    if (_lastCount.hasValue() && elapsed > 0 && count >= _lastCount.get()) {
+        const double rate = static_cast<double>(count - _lastCount.get()) * 1000.0 / static_cast<double>(elapsed);
+        _rate->setText( tr("%1 elements/s").arg( rate, 0, 'f', 0 ));
+    } else {
+        _rate->setText( tr("-") );
+    }
+    _lastCount = Option<size_t>( count );
+}
+
+void PerfPanel::clear() {
+    _rate->setText( tr("-") );
+    _cache->setText( tr("-") );
+    _trims->setText( tr("-") );
+    _depth->setText( tr("-") );
+    _stages->setRowCount( 0 );
+}
+
+QString PerfPanel::formatBytes( const size_t bytes ) {
+    if (bytes < 1024) {
+        return tr("%1 B").arg( bytes );
+    } else if (bytes < 1024 * 1024) {
+        return tr("%1 KiB").arg( bytes / 1024.0, 0, 'f', 1 );
+    } else {
+        return tr("%1 MiB").arg( bytes / (1024.0 * 1024.0), 0, 'f', 1 );
+    }
+}
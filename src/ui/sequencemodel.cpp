@@ -0,0 +1,91 @@
+#include "sequencemodel.hpp"
+
+SequenceModel::SequenceModel( QObject* parent ) 
+    : QAbstractListModel(parent) 
+{}
+
+int SequenceModel::rowCount( const QModelIndex& parent ) const {
+    return parent.isValid() ? 0 : static_cast<int>( _rows.size() );
+}
+
+QVariant SequenceModel::data( const QModelIndex& index, int role ) const {
+    if (!index.isValid() || index.row() >= _rows.size()) {
+        return QVariant();
+    }
+    const Row& row = _rows[index.row()];
+    if (role == Qt::DisplayRole) {
+        if (_isFrozen) {
+            return row.isRendered ? row.text : QString( "{...}" );
+        }
+        size_t count = row.sequence->getMaterializedCount();
+        if (!row.isRendered || row.renderedCount != count) {
+            row.text = render( row.sequence );
+            row.renderedCount = count;
+            row.isRendered = true;
+        }
+        return row.text;
+    } else if (role == SEQUENCE_ROLE) {
+        return QVariant::fromValue( row.sequence );
+    }
+    return QVariant();
+}
+
+void SequenceModel::append( const SharedPtr<LazySequence<int>>& seq ) {
+    int row = static_cast<int>( _rows.size() );
+    beginInsertRows( QModelIndex(), row, row );
+    Row added;
+    added.sequence = seq;
+    _rows.append( added );
+    endInsertRows();
+}
+
+void SequenceModel::remove( const int row ) {
+    if (row < 0 || row >= _rows.size()) {
+        throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+    }
+    beginRemoveRows( QModelIndex(), row, row );
+    _rows.removeAt( row );
+    endRemoveRows();
+}
+
+SharedPtr<LazySequence<int>> SequenceModel::sequenceAt( const int row ) const {
+    if (row < 0 || row >= _rows.size()) {
+        throw Exception( Exception::ErrorCode::INVALID_SELECTION );
+    }
+    return _rows[row].sequence;
+}
+
+// consecutive changed rows are reported as one range
+void SequenceModel::refresh() {
+    if (_isFrozen) {
+        return;
+    }
+    int first = -1;
+    for (int i = 0; i <= _rows.size(); i++) {
+        bool isChanged = i < _rows.size() 
+                      && _rows[i].isRendered 
+                      && _rows[i].renderedCount != _rows[i].sequence->getMaterializedCount();
+        if (isChanged && first < 0) {
+            first = i;
+        } else if (!isChanged && first >= 0) {
+            emit dataChanged( index(first), index(i - 1), { Qt::DisplayRole } );
+            first = -1;
+        }
+    }
+}
+
+void SequenceModel::setFrozen( const bool isFrozen ) {
+    _isFrozen = isFrozen;
+    refresh();
+}
+
+QString SequenceModel::render( const SharedPtr<LazySequence<int>>& seq ) {
+    auto tail = seq->getMaterializedTail( SHOWN_COUNT );
+    QString res = "{";
+    for (size_t i = 0; i < tail.getSize(); i++) {
+        if (i != 0) { res += ", "; }
+        res += QString::number( tail[static_cast<int>(i)] );
+    }
+    res += "}";
+    return res;
+}
@@ -0,0 +1,69 @@
+#include <utility>
+
+template <typename T>
+Coroutine<T> Coroutine<T>::promise_type::get_return_object() {
+    return Coroutine<T>( handle::from_promise( *this ));
+}
+
+template <typename T>
+std::suspend_always Coroutine<T>::promise_type::yield_value( const T& value ) noexcept {
+    _current = &value;
+    return {};
+}
+
+template <typename T>
+std::suspend_always Coroutine<T>::promise_type::yield_value( T&& value ) noexcept {
+    _current = &value;
+    return {};
+}
+
+template <typename T>
+Coroutine<T>::Coroutine() : _coroutine( nullptr ) {}
+
+template <typename T>
+Coroutine<T>::Coroutine( Coroutine<T>&& other ) noexcept
+: _coroutine( std::exchange( other._coroutine, nullptr )) {}
+
+template <typename T>
+Coroutine<T>& Coroutine<T>::operator=( Coroutine<T>&& other ) noexcept {
+    if (this != &other) {
+        if (_coroutine) {
+            _coroutine.destroy();
+        }
+        _coroutine = std::exchange( other._coroutine, nullptr );
+    }
+    return *this;
+}
+
+template <typename T>
+Coroutine<T>::~Coroutine() {
+    if (_coroutine) {
+        _coroutine.destroy();
+    }
+}
+
+template <typename T>
+bool Coroutine<T>::next() {
+    if (isDone()) {
+        return false;
+    }
+    _coroutine.promise()._current = nullptr;
+    _coroutine.resume();
+    if (_coroutine.promise()._error) {
+        std::rethrow_exception( std::exchange( _coroutine.promise()._error, nullptr ));
+    }
+    return !_coroutine.done();
+}
+
+template <typename T>
+const T& Coroutine<T>::getValue() const {
+    if (!_coroutine || _coroutine.promise()._current == nullptr) {
+        throw Exception( Exception::ErrorCode::NULL_DEREFERENCE );
+    }
+    return *_coroutine.promise()._current;
+}
+
+template <typename T>
+bool Coroutine<T>::isDone() const {
+    return !_coroutine || _coroutine.done();
+}
@@ -0,0 +1,76 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+inline TextReader::TextReader( const std::string& path, const size_t blockSize )
+: _fd( -1 ), _buffer( nullptr ), _capacity( blockSize ), _begin(0), _end(0), _isEof( false ) {
+    if (blockSize == 0) {
+        throw Exception( Exception::ErrorCode::INVALID_SIZE );
+    }
+    _fd = open( path.c_str(), O_RDONLY );
+    if (_fd < 0) {
+        throw Exception( "Error. Unable to open the text file." );
+    }
+    posix_fadvise( _fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    _buffer = new char[_capacity];
+}
+
+inline TextReader::~TextReader() {
+    delete[] _buffer;
+    if (_fd >= 0) {
+        close( _fd );
+    }
+}
+
+inline bool TextReader::nextToken( std::string_view& token ) {
+    for (;;) {
+        while (_begin < _end && isSeparator( _buffer[_begin] )) {
+            _begin++;
+        }
+        if (_begin == _end) {
+            if (_isEof) {
+                return false;
+            }
+            refill();
+            continue;
+        }
+        size_t last = _begin;
+        while (last < _end && !isSeparator( _buffer[last] )) {
+            last++;
+        }
+        if (last == _end && !_isEof) { // the token might go on in the next block
+            if (_begin == 0 && _end == _capacity) {
+                throw Exception( Exception::ErrorCode::INVALID_SIZE );
+            }
+            refill();
+            continue;
+        }
+        token = std::string_view( _buffer + _begin, last - _begin );
+        _begin = last;
+        return true;
+    }
+}
+
+inline bool TextReader::refill() {
+    std::memmove( _buffer, _buffer + _begin, _end - _begin );
+    _end -= _begin;
+    _begin = 0;
+    ssize_t count = 0;
+    do {
+        count = read( _fd, _buffer + _end, _capacity - _end );
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) {
+        throw Exception( "Error. Unable to read the text file." );
+    }
+    if (count == 0) {
+        _isEof = true;
+        return false;
+    }
+    _end += static_cast<size_t>( count );
+    return true;
+}
+
+inline bool TextReader::isSeparator( const char c ) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == ',' || c == ';';
+}
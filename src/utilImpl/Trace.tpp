@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <fstream>
+
+inline TraceBuffer::TraceBuffer( const size_t capacity, const uint32_t threadId )
+: _events( new TraceEvent[capacity] ), _capacity( capacity ), _written(0), _threadId( threadId ) {}
+
+inline TraceBuffer::~TraceBuffer() {
+    delete[] _events;
+}
+
+// the counter is published after the slot is written, so a reader sees complete events only
+inline void TraceBuffer::record( const char* name, const void* instance, const char phase ) {
+    size_t written = _written.load( std::memory_order_relaxed );
+    _events[written % _capacity] = TraceEvent { name, instance, Tracer::instance().now(), phase };
+    _written.store( written + 1, std::memory_order_release );
+}
+
+inline void TraceBuffer::clear() {
+    _written.store( 0, std::memory_order_release );
+}
+
+inline size_t TraceBuffer::getSize() const {
+    size_t written = _written.load( std::memory_order_acquire );
+    return written < _capacity ? written : _capacity;
+}
+
+inline const TraceEvent& TraceBuffer::operator[]( const size_t index ) const {
+    size_t written = _written.load( std::memory_order_acquire );
+    if (index >= getSize()) {
+        throw Exception( Exception::ErrorCode::INDEX_OUT_OF_BOUNDS );
+    }
+    size_t first = written < _capacity ? 0 : written - _capacity;
+    return _events[(first + index) % _capacity];
+}
+
+inline Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+inline Tracer::Tracer()
+: _start( std::chrono::steady_clock::now() ), _lock(), _buffers( nullptr ), _bufferCount(0), _bufferCapacity(0) {}
+
+inline Tracer::~Tracer() {
+    for (size_t index = 0; index < _bufferCount; index++) {
+        delete _buffers[index];
+    }
+    delete[] _buffers;
+}
+
+inline TraceBuffer& Tracer::threadBuffer() {
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+        std::lock_guard<std::mutex> guard( _lock );
+        if (_bufferCount == _bufferCapacity) {
+            _bufferCapacity = _bufferCapacity == 0 ? 8 : 2 * _bufferCapacity;
+            auto buffers = new TraceBuffer*[_bufferCapacity];
+            for (size_t index = 0; index < _bufferCount; index++) {
+                buffers[index] = _buffers[index];
+            }
+            delete[] _buffers;
+            _buffers = buffers;
+        }
+        buffer = new TraceBuffer( BUFFER_CAPACITY, static_cast<uint32_t>( _bufferCount + 1 ));
+        _buffers[_bufferCount++] = buffer;
+    }
+    return *buffer;
+}
+
+inline uint64_t Tracer::now() const {
+    return static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - _start ).count() );
+}
+
+// names come from __PRETTY_FUNCTION__, the only characters among them which need escaping are quotes
+inline void Tracer::dump( std::ostream& out ) {
+    std::lock_guard<std::mutex> guard( _lock );
+    out << "{\"traceEvents\":[";
+    bool isFirst = true;
+    char number[32];
+    for (size_t bufferIndex = 0; bufferIndex < _bufferCount; bufferIndex++) {
+        const TraceBuffer& buffer = *_buffers[bufferIndex];
+        for (size_t index = 0; index < buffer.getSize(); index++) {
+            const TraceEvent& event = buffer[index];
+            out << (isFirst ? "\n" : ",\n") << "{\"name\":\"";
+            for (const char* symbol = event.name; *symbol != '\0'; symbol++) {
+                if (*symbol == '"' || *symbol == '\\') {
+                    out << '\\';
+                }
+                out << *symbol;
+            }
+            std::snprintf( number, sizeof(number), "%.3f", static_cast<double>( event.timestamp ) / 1000.0 );
+            out << "\",\"cat\":\"lazy\",\"ph\":\"" << event.phase << "\",\"ts\":" << number
+                << ",\"pid\":1,\"tid\":" << buffer.getThreadId()
+                << ",\"args\":{\"instance\":\"" << event.instance << "\"}}";
+            isFirst = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+inline void Tracer::dump( const std::string& path ) {
+    std::ofstream out( path, std::ios::trunc );
+    if (!out) {
+        throw Exception( Exception::ErrorCode::INVALID_INPUT );
+    }
+    dump( out );
+}
+
+inline void Tracer::clear() {
+    std::lock_guard<std::mutex> guard( _lock );
+    for (size_t index = 0; index < _bufferCount; index++) {
+        _buffers[index]->clear();
+    }
+}
+
+inline TraceScope::TraceScope( const char* name, const void* instance )
+: _buffer( Tracer::instance().threadBuffer() ), _name( name ), _instance( instance ) {
+    _buffer.record( _name, _instance, 'B' );
+}
+
+inline TraceScope::~TraceScope() {
+    _buffer.record( _name, _instance, 'E' );
+}
@@ -1,7 +1,18 @@
 #include <gtest/gtest.h>
 #include "LazySequence.hpp"
 #include "ArraySequence.hpp"
+#include "HeightMapGenerator.hpp"
+#include "HeightMapWorld.hpp"
+#include "HeightMapWriter.hpp"
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <ranges>
+#include <thread>
+#include <vector>
 
 // Basic Construction Tests
 TEST(LazySequenceTest, EmptySequence) {
@@ -158,6 +169,1084 @@ TEST(LazySequenceTest, WhereFilter) {
     EXPECT_EQ((*filtered)[Ordinal(1)], 4);
 }
 
+TEST(LazySequenceTest, WhereRandomAccess) {
+    auto seq = LazySequence<int>::create(1)->append(2)->append(3)->append(4)->append(5)->append(6);
+    WhereGenerator<int> gen([](int x) { return x % 2 == 0; }, seq);
+    EXPECT_EQ(gen.get(Ordinal(1)), 4);
+    EXPECT_EQ(gen.get(Ordinal(0)), 2);
+    EXPECT_EQ(gen.getNext(), 2);
+    EXPECT_EQ(gen.getNext(), 4);
+    EXPECT_EQ(gen.getNext(), 6);
+    EXPECT_FALSE(gen.hasNext());
+    EXPECT_THROW(gen.get(Ordinal(3)), Exception);
+}
+
+TEST(LazySequenceTest, WherePositionsAreTrimmed) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    WhereGenerator<int> gen([](int x) { return x % 2 == 0; }, naturals);
+    int last = 0;
+    for (int i = 0; i < 20'000; i++) {
+        last = gen.getNext();
+    }
+    EXPECT_EQ(last, 40'000);
+    EXPECT_EQ(gen.get(Ordinal(19'999)), 40'000);
+    EXPECT_LE(gen.getStateBytes(), 8'192 * sizeof(size_t) + sizeof(int));
+    EXPECT_DOUBLE_EQ(gen.getPullFactor(), 2.0);
+    try {
+        gen.get(Ordinal(0));
+        FAIL();
+    } catch ( Exception& ex ) {
+        EXPECT_EQ(ex.getCode(), Exception::ErrorCode::DEMATERIALIZED_ACCESS);
+    }
+}
+
+TEST(LazySequenceTest, TrimmedWhereIndexThrows) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto evens = naturals->where([](int x) { return x % 2 == 0; });
+    for (int i = 0; i < 5'000; i++) {
+        evens->memoiseNext();
+    }
+    ASSERT_GT(evens->getMaterializedCount(), evens->getMaterialized().getSize());
+    try {
+        (*evens)[Ordinal(0)];
+        FAIL();
+    } catch ( Exception& ex ) {
+        EXPECT_EQ(ex.getCode(), Exception::ErrorCode::DEMATERIALIZED_ACCESS);
+    }
+    EXPECT_EQ((*evens)[Ordinal(4'999)], 10'000);
+}
+
+TEST(LazySequenceTest, WhereIndexReachesBehindCache) {
+    std::vector<int> data(100'000);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<int>(i);
+    }
+    auto buffer = makeShared<BorrowedBuffer<int>>(data.data(), data.size());
+    auto naturals = LazySequence<int>::fromSource(SharedPtr<ContiguousSource<int>>(buffer));
+    auto evens = naturals->where([](int x) { return x % 2 == 0; });
+    for (int i = 0; i < 5'000; i++) {
+        evens->memoiseNext();
+    }
+    ASSERT_GT(evens->getMaterializedCount(), evens->getMaterialized().getSize());
+    EXPECT_EQ((*evens)[Ordinal(100)], 200); // from the recorded position, the parent is random access
+    EXPECT_EQ((*evens)[Ordinal(0)], 0);
+    EXPECT_EQ(evens->memoiseNext(), 10'000);
+}
+
+TEST(LazySequenceTest, WhereHasNextKeepsElements) {
+    auto seq = LazySequence<int>::create(1)->append(2)->append(3)->append(4);
+    auto filtered = seq->where([](int x) { return x % 2 == 0; });
+    EXPECT_TRUE(filtered->canMemoiseNext());
+    EXPECT_TRUE(filtered->canMemoiseNext());
+    EXPECT_EQ(filtered->memoiseNext(), 2);
+    EXPECT_EQ(filtered->memoiseNext(), 4);
+    EXPECT_FALSE(filtered->canMemoiseNext());
+}
+
+TEST(LazySequenceTest, WhereSparseUnbounded) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto sparse = naturals->where([](int x) { return x % 20'000 == 0; });
+    EXPECT_EQ(sparse->memoiseNext(), 20'000);
+    EXPECT_EQ(sparse->memoiseNext(), 40'000);
+}
+
+TEST(LazySequenceTest, WhereBudgetResumes) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto sparse = naturals->where([](int x) { return x % 1'000 == 0; }, ScanBudget(100));
+    int exhausted = 0;
+    Option<int> found;
+    while (!found.hasValue()) {
+        try {
+            found = sparse->memoiseNext();
+        } catch ( Exception& ) {
+            exhausted++;
+        }
+    }
+    EXPECT_GT(exhausted, 0);
+    EXPECT_EQ(found.get(), 1'000);
+}
+
+TEST(LazySequenceTest, WhereBudgetReportsStatus) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto sparse = naturals->where([](int x) { return x % 1'000 == 0; });
+    EXPECT_EQ(sparse->tryMemoiseNext(ScanBudget(100)), ScanStatus::BUDGET_EXHAUSTED);
+    EXPECT_EQ(sparse->getMaterializedCount(), 0u);
+    EXPECT_EQ(sparse->tryMemoiseNext(ScanBudget(1'000)), ScanStatus::FOUND);
+    EXPECT_EQ(sparse->getFirst(), 1'000);
+
+    auto bounded = naturals->where([](int x) { return x % 1'000 == 0; }, ScanBudget(100));
+    auto mapped = bounded->map<int>([](int x) { return x + 1; });
+    EXPECT_FALSE(mapped->canMemoiseNext());
+    EXPECT_FALSE(mapped->tryMemoiseNext().hasValue());
+    auto cursor = mapped->stream(0, 4).begin();
+    EXPECT_TRUE(cursor == std::default_sentinel);
+    EXPECT_EQ(cursor.getStatus(), ScanStatus::BUDGET_EXHAUSTED);
+    EXPECT_THROW(mapped->memoiseNext(), Exception);
+
+    auto finite = LazySequence<int>::create(initial)->where([](int x) { return x > 1; });
+    EXPECT_EQ(finite->tryMemoiseNext(ScanBudget(100)), ScanStatus::FINISHED);
+}
+
+// Batch Kernel Tests
+TEST(LazySequenceTest, BatchKernelsMatchScalar) {
+    for (auto isa : { KernelIsa::SCALAR, KernelIsa::SSE2, KernelIsa::AVX2 }) {
+        ArraySequence<int> ints;
+        ArraySequence<float> floats;
+        for (int i = -37; i < 37; i++) {
+            ints.append(i);
+            floats.append(i * 0.5f);
+        }
+        BatchKernels<int>::map(ints.getData(), ints.getSize(), ArithmeticOp<int>::mul(-3), isa);
+        BatchKernels<float>::map(floats.getData(), floats.getSize(), ArithmeticOp<float>::add(1.0f), isa);
+        for (int i = -37; i < 37; i++) {
+            EXPECT_EQ(ints[i + 37], i * -3);
+            EXPECT_FLOAT_EQ(floats[i + 37], i * 0.5f + 1.0f);
+        }
+        size_t kept = BatchKernels<int>::where(ints.getData(), ints.getSize(), ComparisonOp<int>::lessEqual(0), isa);
+        ASSERT_EQ(kept, 37u);
+        for (size_t i = 0; i < kept; i++) {
+            EXPECT_EQ(ints[i], static_cast<int>(i) * -3);
+        }
+    }
+}
+
+TEST(LazySequenceTest, BatchKernelsWrapOnOverflow) {
+    for (auto isa : { KernelIsa::SCALAR, KernelIsa::SSE2, KernelIsa::AVX2 }) {
+        ArraySequence<int> sums;
+        ArraySequence<int> products;
+        for (int i = 0; i < 19; i++) { // vector body and scalar tail
+            sums.append(INT32_MAX - i);
+            products.append(INT32_MAX - i);
+        }
+        BatchKernels<int>::map(sums.getData(), sums.getSize(), ArithmeticOp<int>::add(10), isa);
+        BatchKernels<int>::map(products.getData(), products.getSize(), ArithmeticOp<int>::mul(3), isa);
+        for (int i = 0; i < 19; i++) {
+            EXPECT_EQ(sums[i], static_cast<int>(static_cast<uint32_t>(INT32_MAX - i) + 10u));
+            EXPECT_EQ(products[i], static_cast<int>(static_cast<uint32_t>(INT32_MAX - i) * 3u));
+        }
+    }
+    EXPECT_EQ(ArithmeticOp<int16_t>::mul(256)(int16_t(300)), int16_t(11'264)); // narrower than int, wraps at 16 bits
+}
+
+TEST(LazySequenceTest, ArrayMapWhereUseKernels) {
+    ArraySequence<int> seq;
+    for (int i = 0; i < 100; i++) {
+        seq.append(i);
+    }
+    seq.map(ArithmeticOp<int>::add(1));
+    seq.where(ComparisonOp<int>::greater(90));
+    ASSERT_EQ(seq.getSize(), 10u);
+    EXPECT_EQ(seq[0], 91);
+    seq.where([](int x) { return x % 2 == 0; });
+    ASSERT_EQ(seq.getSize(), 5u);
+    EXPECT_EQ(seq[4], 100);
+}
+
+// Height Map Tests
+TEST(LazySequenceTest, ChunkIsFlatRowMajorTile) {
+    HeightMapGenerator gen(0.0f, 16, 1.0f);
+    chunk ch = gen.getNext();
+    EXPECT_EQ(ch.getSize(), 16u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ch.getData()) % TILE_ALIGNMENT, 0u);
+    EXPECT_EQ(ch[3][5], ch(5, 3));
+    EXPECT_EQ(ch.row(5)[3], ch(5, 3));
+    column last = ch[15];
+    EXPECT_EQ(last[7], ch(7, 15));
+
+    Tile<16> fixed = gen.nextTile<16>();
+    EXPECT_EQ(fixed.getBytes(), 16 * 16 * sizeof(float));
+    EXPECT_THROW(gen.nextTile<32>(), Exception);
+}
+
+TEST(LazySequenceTest, HeightMapIsSeekable) {
+    HeightMapGenerator sequential(0.5f, 16, 1.0f, 42);
+    HeightMapGenerator seeking(0.5f, 16, 1.0f, 42);
+    seeking.setCheckpointInterval(4);
+    ArraySequence<chunk> expected;
+    for (int i = 0; i < 11; i++) {
+        expected.append(sequential.getNext());
+    }
+    auto compare = [](const chunk& a, const chunk& b) {
+        for (size_t i = 0; i < a.getCount(); i++) {
+            if (a.getData()[i] != b.getData()[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+    EXPECT_TRUE(compare(seeking.get(Ordinal(9)), expected[9]));
+    EXPECT_TRUE(compare(seeking.get(Ordinal(2)), expected[2]));
+    EXPECT_TRUE(compare(seeking.getNext(), expected[0]));
+
+    auto range = seeking.getRange(3, 8, 3);
+    ASSERT_EQ(range.getSize(), 8u);
+    for (size_t i = 0; i < 8; i++) {
+        EXPECT_TRUE(compare(range[i], expected[i + 3]));
+    }
+    EXPECT_FALSE(compare(HeightMapGenerator(0.5f, 16, 1.0f, 43).getNext(), expected[0]));
+}
+
+TEST(LazySequenceTest, HeightMapWavefrontMatchesRowMajor) {
+    for (size_t size : { 32, 33, 64, 100, 130 }) {
+        HeightMapGenerator rowMajor(0.25f, size, 2.0f, 7);
+        HeightMapGenerator wavefront(0.25f, size, 2.0f, 7);
+        rowMajor.setKernel(ChunkKernel::ROW_MAJOR);
+        wavefront.setKernel(ChunkKernel::WAVEFRONT);
+        for (int i = 0; i < 3; i++) {
+            auto expected = rowMajor.getNext();
+            auto actual = wavefront.getNext();
+            for (size_t cell = 0; cell < expected.getCount(); cell++) {
+                ASSERT_EQ(expected.getData()[cell], actual.getData()[cell]) << "size " << size << ", cell " << cell;
+            }
+        }
+    }
+}
+
+TEST(LazySequenceTest, HeightMapWorldSeamsAndCache) {
+    const size_t tileBytes = 16 * 16 * sizeof(float) + sizeof(chunk) + LruCache<TileCoord, SharedPtr<chunk>, TileCoordHash>::ENTRY_OVERHEAD;
+    HeightMapWorld world(5, 16, 1.0f, 8 * tileBytes);
+    float seamJump = 0.0f;
+    float innerJump = 0.0f;
+    for (int64_t y = -40; y < 40; y++) {
+        for (int64_t x = -40; x < 40; x++) {
+            float here = world.getHeight(x, y);
+            float right = std::abs(here - world.getHeight(x + 1, y));
+            float below = std::abs(here - world.getHeight(x, y + 1));
+            float& horizontal = (x + 1) % 16 == 0 ? seamJump : innerJump;
+            float& vertical = (y + 1) % 16 == 0 ? seamJump : innerJump;
+            horizontal = std::max(horizontal, right);
+            vertical = std::max(vertical, below);
+        }
+    }
+    // crossing a tile border is no steeper than moving inside a tile
+    EXPECT_LT(seamJump, innerJump * 1.5f);
+    EXPECT_LE(world.getCache().getBytes(), 8 * tileBytes);
+    EXPECT_GT(world.getCache().getEvictions(), 0u);
+
+    auto tile = world.get(-3, 2);
+    chunk regenerated = HeightMapWorld(5, 16, 1.0f).generate(-3, 2);
+    EXPECT_EQ((*tile)(7, 9), regenerated(7, 9));
+
+    chunk raised = HeightMapWorld(5, 16, 1.0f, HeightMapWorld::DEFAULT_CACHE_CAPACITY, 100.0f).generate(-3, 2);
+    for (size_t row = 0; row < 16; row++) {
+        for (size_t col = 0; col < 16; col++) {
+            EXPECT_NEAR(raised(row, col), regenerated(row, col) + 100.0f, 1e-3f); // the same map, shifted
+        }
+    }
+}
+
+// Height Map Writer Tests
+static std::string writeHeightMap(const HeightMapFormat format, const std::string& name) {
+    const float rows[2][3] = { { 0.0f, 0.5f, 1.0f }, { -1.0f, 2.0f, 0.25f } };
+    std::string path = testing::TempDir() + name;
+    {
+        auto writer = makeHeightMapWriter(format, path, 3, 2, HeightRange{ 0.0f, 1.0f });
+        writer->writeRow(rows[0]);
+        writer->writeRow(rows[1]);
+        writer->finish();
+    }
+    std::ifstream in(path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path.c_str());
+    return bytes;
+}
+
+TEST(LazySequenceTest, RawHeightMapWriter) {
+    std::string bytes = writeHeightMap(HeightMapFormat::RAW, "height_map.raw");
+    ASSERT_EQ(bytes.size(), 24u + 6 * sizeof(float));
+    EXPECT_EQ(bytes.substr(0, 4), "HMAP");
+    uint32_t version = 0;
+    uint64_t width = 0;
+    uint64_t height = 0;
+    std::memcpy(&version, bytes.data() + 4, sizeof(version));
+    std::memcpy(&width, bytes.data() + 8, sizeof(width));
+    std::memcpy(&height, bytes.data() + 16, sizeof(height));
+    EXPECT_EQ(version, 1u);
+    EXPECT_EQ(width, 3u);
+    EXPECT_EQ(height, 2u);
+    float last = 0.0f;
+    std::memcpy(&last, bytes.data() + bytes.size() - sizeof(float), sizeof(float));
+    EXPECT_EQ(last, 0.25f); // stored as is, not clamped to the range
+}
+
+TEST(LazySequenceTest, PgmHeightMapWriter) {
+    std::string bytes = writeHeightMap(HeightMapFormat::PGM, "height_map.pgm");
+    const std::string header = "P5\n3 2\n65535\n";
+    ASSERT_EQ(bytes.size(), header.size() + 6 * 2);
+    EXPECT_EQ(bytes.substr(0, header.size()), header);
+    const std::string samples("\x00\x00\x80\x00\xFF\xFF\x00\x00\xFF\xFF\x40\x00", 12); // big-endian, clamped
+    EXPECT_EQ(bytes.substr(header.size()), samples);
+}
+
+TEST(LazySequenceTest, PngHeightMapWriter) {
+    std::string bytes = writeHeightMap(HeightMapFormat::PNG, "height_map.png");
+    // signature, IHDR, an IDAT per row with the zlib header in the first and the adler32 in the last one, IEND
+    ASSERT_EQ(bytes.size(), 8u + (12 + 13) + (12 + 2 + 5 + 7) + (12 + 5 + 7 + 4) + 12);
+    EXPECT_EQ(bytes.substr(0, 8), std::string("\x89PNG\r\n\x1a\n", 8));
+    EXPECT_EQ(bytes.substr(12, 4), "IHDR");
+    EXPECT_EQ(bytes.substr(16, 8), std::string("\0\0\0\x03\0\0\0\x02", 8));
+    EXPECT_EQ(bytes[24], 16); // bit depth
+    EXPECT_EQ(bytes.substr(37, 4), "IDAT");
+    EXPECT_EQ(bytes.substr(41, 2), "\x78\x01");
+    EXPECT_EQ(bytes.substr(bytes.size() - 8, 4), "IEND");
+}
+
+TEST(LazySequenceTest, CsvHeightMapWriter) {
+    EXPECT_EQ(writeHeightMap(HeightMapFormat::CSV, "height_map.csv"), "0,0.5,1\n-1,2,0.25\n");
+
+    std::string path = testing::TempDir() + "height_map_short.csv";
+    const float row[3] = { 0.0f, 0.0f, 0.0f };
+    CsvHeightMapWriter writer(path, 3, 1);
+    EXPECT_THROW(writer.finish(), Exception); // not all rows were written
+    writer.writeRow(row);
+    EXPECT_THROW(writer.writeRow(row), Exception);
+    std::remove(path.c_str());
+}
+
+// Prefetch Tests
+TEST(LazySequenceTest, PrefetchKeepsOrder) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    naturals->enablePrefetch(8);
+    EXPECT_TRUE(naturals->isPrefetching());
+    for (int i = 0; i < 5'000; i++) {
+        EXPECT_EQ(naturals->memoiseNext(), i + 2); // the initial element is already cached
+    }
+}
+
+TEST(LazySequenceTest, PrefetchPropagatesExceptions) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto failing = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        if (window[0] == 10) {
+            throw Exception(Exception::ErrorCode::INVALID_INPUT);
+        }
+        return window[0] + 1;
+    }, initial);
+    failing->enablePrefetch(4);
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_EQ(failing->memoiseNext(), i);
+    }
+    EXPECT_THROW(failing->memoiseNext(), Exception);
+}
+
+TEST(LazySequenceTest, PrefetchFiniteAndShutdown) {
+    ArraySequence<int> data;
+    for (int i = 0; i < 100; i++) {
+        data.append(i);
+    }
+    auto seq = LazySequence<int>::create(data);
+    seq->enablePrefetch(16);
+    int count = 0;
+    while (seq->canMemoiseNext()) {
+        EXPECT_EQ(seq->memoiseNext(), count++);
+    }
+    EXPECT_EQ(count, 100);
+
+    // dropped while the worker is blocked on a full ring
+    ArraySequence<int> initial;
+    initial.append(7);
+    auto infinite = LazySequence<int>::create(1, [](ArraySequence<int>& window) { return window[0]; }, initial);
+    infinite->enablePrefetch(2);
+    infinite->memoiseNext();
+}
+
+TEST(LazySequenceTest, PrefetchGetReadsBufferedElements) {
+    ArraySequence<int> initial;
+    initial.append(1);
+    auto source = makeShared<InfiniteGenerator<int>>(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    PrefetchGenerator<int> prefetch(SharedPtr<IGenerator<int>>(source), 4, 1); // the initial element has index 0
+    EXPECT_EQ(prefetch.getNext(), 2);
+    while (prefetch.getBuffered() < prefetch.getDepth()) {
+        std::this_thread::yield();
+    }
+    // the wrapped generator has already moved past all of them
+    for (int i = 2; i < 6; i++) {
+        EXPECT_EQ(prefetch.get(i), i + 1);
+    }
+    EXPECT_THROW(prefetch.get(1), Exception);
+    EXPECT_EQ(prefetch.getNext(), 3);
+}
+
+TEST(LazySequenceTest, PrefetchResumesBudgetedScans) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto sparse = naturals->where([](int x) { return x % 1'000 == 0; }, ScanBudget(100));
+    sparse->enablePrefetch(8);
+    int found = 0;
+    for (int attempt = 0; attempt < 1'000'000 && found < 5; attempt++) {
+        ScanStatus status = sparse->tryMemoiseNext(ScanBudget(100));
+        ASSERT_NE(status, ScanStatus::FINISHED);
+        if (status == ScanStatus::FOUND) {
+            EXPECT_EQ((*sparse)[Ordinal(found)], found * 1'000);
+            found++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    EXPECT_EQ(found, 5);
+    EXPECT_TRUE(sparse->canMemoiseNext()); // waits for the worker instead of giving up on the own budget
+    EXPECT_EQ(sparse->memoiseNext(), 5'000);
+}
+
+TEST(LazySequenceTest, PrefetchRejectsSharedParents) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto doubled = naturals->map<int>([](int x) { return x * 2; });
+    doubled->enablePrefetch(4); // the only sequence reading naturals
+    EXPECT_EQ(doubled->memoiseNext(), 0);
+
+    auto shared = LazySequence<int>::create(1)->append(2);
+    auto squares = shared->map<int>([](int x) { return x * x; });
+    auto negated = shared->map<int>([](int x) { return -x; });
+    try {
+        squares->enablePrefetch(4);
+        FAIL();
+    } catch ( Exception& ex ) {
+        EXPECT_EQ(ex.getCode(), Exception::ErrorCode::SHARED_PARENT);
+    }
+    EXPECT_FALSE(squares->isPrefetching());
+}
+
+// Coroutine Tests
+TEST(LazySequenceTest, CoroutineSequence) {
+    auto fibonacci = LazySequence<long>::create([]() -> Coroutine<long> {
+        long prev = 0;
+        long curr = 1;
+        while (true) {
+            co_yield prev;
+            long next = prev + curr;
+            prev = curr;
+            curr = next;
+        }
+    });
+    EXPECT_FALSE(fibonacci->isFinite());
+    EXPECT_EQ((*fibonacci)[Ordinal(10)], 55);
+    EXPECT_EQ(fibonacci->memoiseNext(), 89);
+    EXPECT_EQ(fibonacci->get(Ordinal(20)), 6765);
+
+    auto squares = LazySequence<int>::create([]() -> Coroutine<int> {
+        for (int i = 0; i < 5; i++) {
+            co_yield i * i;
+        }
+    }, Cardinal(5), Option<Ordinal>(Ordinal(5)));
+    int count = 0;
+    while (squares->canMemoiseNext()) {
+        EXPECT_EQ(squares->memoiseNext(), count * count);
+        count++;
+    }
+    EXPECT_EQ(count, 5);
+
+    auto failing = LazySequence<int>::create([]() -> Coroutine<int> {
+        co_yield 1;
+        throw Exception(Exception::ErrorCode::INVALID_INPUT);
+    });
+    EXPECT_EQ(failing->memoiseNext(), 1);
+    EXPECT_THROW(failing->memoiseNext(), Exception);
+}
+
+TEST(LazySequenceTest, CoroutineGeneratorSurvivesMoves) {
+    auto countFrom = [](int start) {
+        return [start]() -> Coroutine<int> {
+            for (int i = 0; ; i++) {
+                co_yield start + i; // reads the capture on every step
+            }
+        };
+    };
+    CoroutineGenerator<int> first(countFrom(10));
+    EXPECT_EQ(first.getNext(), 10);
+    CoroutineGenerator<int> moved(std::move(first));
+    first = CoroutineGenerator<int>(countFrom(100)); // reuses the storage the body was moved out of
+    EXPECT_EQ(moved.getNext(), 11);
+    EXPECT_EQ(first.getNext(), 100);
+
+    CoroutineGenerator<int> assigned(countFrom(0));
+    assigned = std::move(moved);
+    moved = CoroutineGenerator<int>(countFrom(200));
+    EXPECT_EQ(assigned.getNext(), 12);
+    EXPECT_EQ(assigned.get(Ordinal(3)), 13);
+    EXPECT_EQ(moved.getNext(), 200);
+}
+
+// Counter Tests
+TEST(LazySequenceTest, CountersAggregateOverPipeline) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+        return window[0] + 1;
+    }, initial);
+    auto evens = naturals->where([](int x) { return x % 2 == 0; });
+    auto doubled = evens->map<int>([](int x) { return x * 2; });
+
+    for (int i = 0; i < 10; i++) {
+        doubled->memoiseNext();
+    }
+    EXPECT_EQ((*doubled)[Ordinal(3)], 12); // the cached 0 is read as well
+    auto own = doubled->getCounters(CounterScope::SEQUENCE);
+    EXPECT_EQ(own.sequences, 1u);
+    EXPECT_EQ(own.counters.generatorCalls, 10u);
+    EXPECT_EQ(own.counters.cacheHits, 1u);
+
+    auto total = doubled->getCounters();
+    EXPECT_EQ(total.sequences, 3u);
+    EXPECT_EQ(total.counters.whereRejections, 9u);
+    EXPECT_EQ(total.counters.generatorCalls, 10u + 10u + 18u);
+    EXPECT_GT(own.counters.nanoseconds, 0u);
+    EXPECT_GE(total.counters.nanoseconds, own.counters.nanoseconds);
+
+    for (int i = 0; i < 10'000; i++) { // far enough ahead of evens for the cache to be trimmed under it
+        naturals->memoiseNext();
+    }
+    EXPECT_THROW(naturals->getFirst(), Exception);
+    auto parent = naturals->getCounters(CounterScope::SEQUENCE).counters;
+    EXPECT_GT(parent.trims, 0u);
+    EXPECT_EQ(parent.bytesTrimmed % sizeof(int), 0u);
+    EXPECT_EQ(parent.dematerializedAccesses, 1u);
+
+    naturals->resetCounters();
+    EXPECT_EQ(naturals->getCounters(CounterScope::SEQUENCE).counters.generatorCalls, 0u);
+}
+
+// Trace Tests
+TEST(LazySequenceTest, TraceRecordsNestedPulls) {
+    Tracer::instance().clear();
+    auto doubled = LazySequence<int>::create(1)->append(2)->map<int>([](int x) { return x * 2; });
+    EXPECT_EQ(doubled->memoiseNext(), 2);
+
+    const TraceBuffer& buffer = Tracer::instance().threadBuffer();
+    ASSERT_GE(buffer.getSize(), 6u); // memoiseNext of three sequences, each with its generator pull
+    int depth = 0;
+    for (size_t i = 0; i < buffer.getSize(); i++) {
+        depth += buffer[i].phase == 'B' ? 1 : -1;
+        EXPECT_GE(depth, 0);
+    }
+    EXPECT_EQ(depth, 0);
+
+    std::ostringstream out;
+    Tracer::instance().dump(out);
+    EXPECT_NE(out.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(out.str().find("MapGenerator"), std::string::npos);
+}
+
+// Explain Tests
+TEST(LazySequenceTest, ExplainDescribesPipeline) {
+    auto appended = LazySequence<int>::create(1)->append(2);
+    auto filtered = appended->map<int>([](int x) { return x * 2; })->where([](int x) { return x > 2; });
+    EXPECT_EQ(filtered->memoiseNext(), 4);
+
+    PipelinePlan plan;
+    plan.visit(*filtered);
+    ASSERT_EQ(plan.getNodeCount(), 5u); // where, map, append and both sides of the append
+    EXPECT_NE(plan.getNode(0).generator.find("WhereGenerator"), std::string::npos);
+    EXPECT_FALSE(plan.getNode(0).ordinality.hasValue());
+    EXPECT_DOUBLE_EQ(plan.getNode(0).pullFactor, 2.0); // 4 is the second element of the map
+    EXPECT_DOUBLE_EQ(plan.getPullCosts()[0], 1.0 + 2.0 * 3.0);
+    EXPECT_EQ(plan.getDepth(), 4u);
+
+    auto self = plan.getSelfNanoseconds();
+    for (size_t node = 0; node < plan.getNodeCount(); node++) {
+        EXPECT_LE(self[node], plan.getNode(node).counters.nanoseconds);
+    }
+    EXPECT_EQ(self[4], plan.getNode(4).counters.nanoseconds); // a source has no parents to subtract
+
+    auto dot = filtered->explain();
+    EXPECT_EQ(dot.find("digraph pipeline"), 0u);
+    EXPECT_NE(dot.find("n2 -> n3;"), std::string::npos);
+
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) { return window[0] + 1; }, initial);
+    auto json = naturals->explain(ExplainFormat::JSON);
+    EXPECT_NE(json.find("\"ordinality\":\"w\""), std::string::npos);
+    EXPECT_NE(json.find("\"edges\":[\n]"), std::string::npos);
+}
+
+// Cache Manager Tests
+TEST(LazySequenceTest, CacheManagerEnforcesBudget) {
+    auto& manager = CacheManager::instance();
+    size_t evictions = manager.getEvictions();
+    ArraySequence<long> firstInitial;
+    firstInitial.append(0);
+    ArraySequence<long> secondInitial;
+    secondInitial.append(0);
+    auto first = LazySequence<long>::create(1, [](ArraySequence<long>& window) { return window[0] + 1; }, firstInitial);
+    auto second = LazySequence<long>::create(1, [](ArraySequence<long>& window) { return window[0] + 2; }, secondInitial);
+
+    struct BudgetGuard {
+        size_t budget = CacheManager::instance().getBudget();
+        ~BudgetGuard() { CacheManager::instance().setBudget(budget); }
+    } guard; // a failed expectation mustn't leave the budget to the other tests
+    manager.setBudget(manager.getBytes() + 1'000 * sizeof(long));
+    for (int i = 0; i < 1'500; i++) {
+        first->memoiseNext();
+        second->memoiseNext();
+    }
+    EXPECT_GT(manager.getEvictions(), evictions);
+    EXPECT_LE(manager.getBytes(), manager.getBudget());
+    EXPECT_LT(first->getMaterialized().getSize() + second->getMaterialized().getSize(), 1'000u);
+    EXPECT_EQ((*first)[Ordinal(1'500)], 1'500); // the newest elements are still cached
+    EXPECT_EQ(first->getMaterializedCount(), 1'501u);
+
+    bool isReported = false;
+    auto report = manager.report();
+    for (size_t i = 0; i < report.getSize(); i++) {
+        if (report[i].owner == static_cast<const void*>(second.operator->())) {
+            isReported = true;
+            EXPECT_EQ(report[i].cacheBytes, second->getMaterialized().getSize() * sizeof(long));
+            EXPECT_EQ(report[i].generatorBytes, sizeof(long)); // the window of the generator
+            EXPECT_NE(report[i].generator.find("InfiniteGenerator"), std::string::npos);
+        }
+    }
+    EXPECT_TRUE(isReported);
+}
+
+TEST(LazySequenceTest, CacheChargeFollowsMoves) {
+    auto& manager = CacheManager::instance();
+    ArraySequence<long> initial;
+    initial.append(0);
+    auto seq = LazySequence<long>::create(1, [](ArraySequence<long>& window) { return window[0] + 1; }, initial);
+    for (int i = 0; i < 100; i++) {
+        seq->memoiseNext(); // charges the cache after every element
+    }
+    size_t cacheBytes = seq->getMaterialized().getSize() * sizeof(long);
+    size_t charged = manager.getBytes();
+    {
+        LazySequence<long> moved(std::move(*seq));
+        EXPECT_EQ(manager.getBytes(), charged);
+
+        ArraySequence<CacheFootprint> report;
+        std::thread other([&report, &manager]() { report = manager.report(); });
+        other.join();
+        bool isReported = false;
+        for (size_t i = 0; i < report.getSize(); i++) {
+            if (report[i].owner == static_cast<const void*>(&moved)) {
+                isReported = true;
+                EXPECT_EQ(report[i].cacheBytes, cacheBytes);
+                EXPECT_TRUE(report[i].generator.empty()); // not read from another thread
+            } else if (report[i].owner == static_cast<const void*>(seq.operator->())) {
+                EXPECT_EQ(report[i].cacheBytes, 0u);
+            }
+        }
+        EXPECT_TRUE(isReported);
+    }
+    EXPECT_EQ(manager.getBytes(), charged - cacheBytes);
+}
+
+TEST(LazySequenceTest, CacheBudgetKeepsLaggingConsumers) {
+    ArraySequence<long> initial;
+    initial.append(0);
+    auto naturals = LazySequence<long>::create(1, [](ArraySequence<long>& window) { return window[0] + 1; }, initial);
+    auto ahead = naturals->map<long>([](long x) { return x; });
+    auto behind = naturals->map<long>([](long x) { return -x; });
+    for (int i = 0; i < 1'500; i++) {
+        ahead->memoiseNext();
+    }
+
+    struct BudgetGuard {
+        size_t budget = CacheManager::instance().getBudget();
+        ~BudgetGuard() { CacheManager::instance().setBudget(budget); }
+    } guard;
+    CacheManager::instance().setBudget(4'096);
+    for (long i = 0; i < 1'500; i++) {
+        EXPECT_EQ(behind->memoiseNext(), -i); // still within CACHE_LAG_MAX_SIZE of the faster sibling
+    }
+}
+
+TEST(LazySequenceTest, SpillServesEvictedElements) {
+    ArraySequence<long> initial;
+    initial.append(0);
+    auto seq = LazySequence<long>::create(1, [](ArraySequence<long>& window) { return window[0] + 1; }, initial);
+    seq->enableSpill();
+    EXPECT_TRUE(seq->isSpilling());
+
+    EXPECT_EQ((*seq)[Ordinal(5'000)], 5'000);
+    EXPECT_EQ((*seq)[Ordinal(5'001)], 5'001); // trims the cache
+    EXPECT_LT(seq->getMaterialized().getSize(), 5'000u);
+    seq->resetCounters();
+
+    EXPECT_EQ(seq->getFirst(), 0);
+    EXPECT_EQ((*seq)[Ordinal(1'234)], 1'234);
+    auto counters = seq->getCounters(CounterScope::SEQUENCE).counters;
+    EXPECT_EQ(counters.spillReads, 2u);
+    EXPECT_EQ(counters.generatorCalls, 0u);
+}
+
+TEST(LazySequenceTest, SnapshotRestoresFrontier) {
+    auto fibonacci = [](ArraySequence<long>& window) { return window[0] + window[1]; };
+    ArraySequence<long> firstInitial;
+    firstInitial.append(0);
+    firstInitial.append(1);
+    ArraySequence<long> secondInitial;
+    secondInitial.append(0);
+    secondInitial.append(1);
+    auto seq = LazySequence<long>::create(2, fibonacci, firstInitial);
+    long expected = (*seq)[Ordinal(90)];
+    std::stringstream snapshot;
+    seq->save(snapshot);
+
+    auto restored = LazySequence<long>::create(2, fibonacci, secondInitial);
+    restored->restore(snapshot);
+    EXPECT_EQ(restored->getMaterializedCount(), seq->getMaterializedCount());
+    EXPECT_EQ((*restored)[Ordinal(90)], expected);
+    EXPECT_EQ(restored->memoiseNext(), seq->memoiseNext());
+
+    std::stringstream foreign;
+    LazySequence<long>::create(1)->save(foreign);
+    EXPECT_THROW(restored->restore(foreign), Exception);
+}
+
+TEST(LazySequenceTest, ExceptionKeepsErrorCode) {
+    EXPECT_EQ(Exception(Exception::ErrorCode::SNAPSHOT_MISMATCH).getCode(), Exception::ErrorCode::SNAPSHOT_MISMATCH);
+    EXPECT_EQ(Exception("Error. Something else.").getCode(), Exception::ErrorCode::UNKNOWN_ERROR);
+    auto seq = LazySequence<int>::create(1);
+    try {
+        (*seq)[Ordinal(1)];
+        FAIL();
+    } catch (Exception& ex) {
+        EXPECT_EQ(ex.getCode(), Exception::ErrorCode::INDEX_OUT_OF_BOUNDS);
+    }
+}
+
+TEST(LazySequenceTest, SnapshotOfMapAndWhere) {
+    auto build = []() {
+        ArraySequence<int> initial;
+        initial.append(1);
+        auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) {
+            return window[0] + 1;
+        }, initial);
+        return naturals->where([](int x) { return x % 3 == 0; })->map<int>([](int x) { return x * 2; });
+    };
+    auto seq = build();
+    for (int i = 0; i < 100; i++) {
+        seq->memoiseNext();
+    }
+    std::stringstream snapshot;
+    seq->save(snapshot);
+
+    auto restored = build();
+    restored->restore(snapshot);
+    EXPECT_EQ(restored->getMaterializedCount(), 100u);
+    EXPECT_EQ((*restored)[Ordinal(50)], (*seq)[Ordinal(50)]);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(restored->memoiseNext(), seq->memoiseNext());
+    }
+    EXPECT_EQ(restored->memoiseNext(), 2 * 3 * 111);
+}
+
+TEST(LazySequenceTest, HeightMapSnapshotRoundTrip) {
+    HeightMapGenerator original(0.5f, 16, 1.0f, 42);
+    original.setCheckpointInterval(4);
+    for (int i = 0; i < 10; i++) {
+        original.getNext();
+    }
+    std::stringstream state;
+    SnapshotWriter out(state);
+    original.saveState(out);
+
+    HeightMapGenerator restored;
+    SnapshotReader in(state);
+    restored.restoreState(in);
+    EXPECT_EQ(restored.getSeed(), 42u);
+    EXPECT_EQ(restored.getSize(), 16u);
+    EXPECT_EQ(restored.getCheckpointInterval(), 4u);
+    EXPECT_EQ(restored.getKernel(), original.getKernel());
+    EXPECT_EQ(restored.getStateBytes(), original.getStateBytes()); // the edge and all three checkpoints
+
+    auto equal = [](const chunk& a, const chunk& b) {
+        return a.getCount() == b.getCount() && std::equal(a.getData(), a.getData() + a.getCount(), b.getData());
+    };
+    EXPECT_TRUE(equal(restored.getNext(), original.getNext())); // continues from the saved edge
+    EXPECT_TRUE(equal(restored.get(Ordinal(6)), original.get(Ordinal(6)))); // recomputed from a checkpoint
+}
+
+TEST(LazySequenceTest, SnapshotRejectsCorruptData) {
+    auto expectMismatch = [](std::stringstream& data, auto read) {
+        SnapshotReader in(data);
+        try {
+            read(in);
+            FAIL() << "corrupt data was read";
+        } catch (Exception& ex) {
+            EXPECT_EQ(ex.getCode(), Exception::ErrorCode::SNAPSHOT_MISMATCH);
+        }
+    };
+    std::stringstream longString;
+    SnapshotWriter(longString).write(size_t(1) << 40);
+    expectMismatch(longString, [](SnapshotReader& in) { in.read<std::string>(); });
+
+    std::stringstream longArray;
+    SnapshotWriter(longArray).write(size_t(4));
+    SnapshotWriter(longArray).write(1L);
+    expectMismatch(longArray, [](SnapshotReader& in) { in.read<ArraySequence<long>>(); });
+
+    std::stringstream hugeChunk;
+    SnapshotWriter(hugeChunk).write(size_t(1) << 33);
+    expectMismatch(hugeChunk, [](SnapshotReader& in) { in.read<chunk>(); });
+
+    std::stringstream badBool;
+    SnapshotWriter(badBool).write(uint8_t(2));
+    expectMismatch(badBool, [](SnapshotReader& in) { in.read<Option<int>>(); });
+
+    std::stringstream goodBool;
+    SnapshotWriter(goodBool).write(true);
+    EXPECT_TRUE(SnapshotReader(goodBool).read<bool>());
+}
+
+TEST(LazySequenceTest, BorrowedAndMappedSources) {
+    long values[] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+    bool isReleased = false;
+    {
+        auto borrowed = LazySequence<long>::borrow(values, 8, [&isReleased]() { isReleased = true; });
+        auto doubled = borrowed->map<long>([](long x) { return x * 2; });
+        EXPECT_EQ((*borrowed)[Ordinal(5)], 9);
+        EXPECT_EQ(borrowed->getMaterializedCount(), 0u); // served without caching
+        EXPECT_EQ((*doubled)[Ordinal(7)], 12);
+        EXPECT_EQ(borrowed->getLast(), 6);
+        EXPECT_THROW((*borrowed)[Ordinal(8)], Exception);
+        borrowed = SharedPtr<LazySequence<long>>();
+        EXPECT_FALSE(isReleased); // still referred to by the mapped sequence
+    }
+    EXPECT_TRUE(isReleased);
+
+    std::string path = testing::TempDir() + "lazy_sequence_mapped.bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(values), sizeof(values));
+    }
+    auto mapped = LazySequence<long>::fromFile(path);
+    EXPECT_EQ(static_cast<size_t>(mapped->getSize()), 8u);
+    EXPECT_EQ((*mapped)[Ordinal(2)], 4);
+    EXPECT_EQ(mapped->memoiseNext(), 3);
+    std::remove(path.c_str());
+}
+
+TEST(LazySequenceTest, MaterializedTail) {
+    auto seq = LazySequence<int>::create(1)->append(2)->append(3)->append(4);
+    EXPECT_EQ(seq->getMaterializedTail(2).getSize(), 0u);
+    (*seq)[Ordinal(3)];
+    auto tail = seq->getMaterializedTail(2);
+    ASSERT_EQ(tail.getSize(), 2u);
+    EXPECT_EQ(tail[0], 3);
+    EXPECT_EQ(tail[1], 4);
+    EXPECT_EQ(seq->getMaterializedTail(10).getSize(), 4u);
+}
+
+TEST(LazySequenceTest, ArrayConstructorKeepsData) {
+    ArraySequence<int> data;
+    data.append(7);
+    data.append(8);
+    auto seq = LazySequence<int>::create(data);
+    EXPECT_EQ((*seq)[Ordinal(0)], 7);
+    EXPECT_EQ((*seq)[Ordinal(1)], 8);
+    EXPECT_EQ(seq->getMaterializedCount(), 2u);
+}
+
+TEST(LazySequenceTest, TextSequenceFindsItsEnd) {
+    std::string path = testing::TempDir() + "lazy_sequence_text.csv";
+    {
+        std::ofstream out(path);
+        out << "1.5, -2,+3\n4.25;5\r\n\n6   7\n";
+    }
+    auto seq = LazySequence<double>::fromText(path, 6); // numbers are split between blocks
+    EXPECT_FALSE(seq->isFinite());
+    EXPECT_EQ((*seq)[Ordinal(3)], 4.25);
+    EXPECT_EQ((*seq)[Ordinal(6)], 7.0);
+    EXPECT_FALSE(seq->canMemoiseNext());
+    EXPECT_TRUE(seq->isFinite());
+    EXPECT_EQ(static_cast<size_t>(seq->getSize()), 7u);
+    EXPECT_THROW((*seq)[Ordinal(7)], Exception);
+    EXPECT_EQ(seq->foldl<double>([](double acc, double x) { return acc + x; }, 0.0), 24.75);
+
+    {
+        std::ofstream out(path);
+        out << "1 2 x3\n";
+    }
+    auto broken = LazySequence<int>::fromText(path);
+    EXPECT_EQ((*broken)[Ordinal(1)], 2);
+    EXPECT_THROW((*broken)[Ordinal(2)], Exception);
+    for (int attempt = 0; attempt < 2; attempt++) { // the bad token isn't skipped to get to the end
+        try {
+            broken->memoiseNext();
+            FAIL();
+        } catch (Exception& ex) {
+            EXPECT_EQ(ex.getCode(), Exception::ErrorCode::UNEXPECTED_CHAR);
+        }
+    }
+    EXPECT_EQ(broken->getMaterializedCount(), 2u);
+    EXPECT_FALSE(broken->isFinite());
+    std::remove(path.c_str());
+}
+
+// Stream Tests
+TEST(LazySequenceTest, StreamWalksInfiniteAndFiniteSequences) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) { return window[0] + 1; }, initial);
+    static_assert(std::ranges::input_range<decltype(naturals->stream())>);
+
+    int expected = 0;
+    for (int value : naturals->stream(0, 100)) {
+        ASSERT_EQ(value, expected);
+        if (++expected == 5'000) { // well past a trim of the cache
+            break;
+        }
+    }
+    auto stream = naturals->stream(4'990); // the start is still cached, the generator of naturals can't replay
+    auto found = std::ranges::find_if(stream, [](int x) { return x > 7'000; });
+    ASSERT_NE(found, std::default_sentinel);
+    EXPECT_EQ(*found, 7'001);
+    EXPECT_EQ(found.getIndex(), 7'001u);
+    EXPECT_EQ((*naturals)[Ordinal(6'999)], 6'999); // streamed elements are cached
+
+    ArraySequence<int> data;
+    for (int i = 1; i <= 10; i++) {
+        data.append(i);
+    }
+    auto evens = LazySequence<int>::create(data)->where([](int x) { return x % 2 == 0; });
+    int sum = 0;
+    for (int value : evens->stream(0, 3)) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 2 + 4 + 6 + 8 + 10);
+
+    const int raw[] = {5, 6, 7};
+    auto borrowed = LazySequence<int>::borrow(raw, 3);
+    EXPECT_EQ(std::ranges::distance(borrowed->stream(1)), 2);
+}
+
+// Window Tests
+TEST(LazySequenceTest, RollingAggregatesSlideOverWindows) {
+    auto naturals = []() {
+        ArraySequence<int> initial;
+        initial.append(0);
+        return LazySequence<int>::create(1, [](ArraySequence<int>& window) { return window[0] + 1; }, initial);
+    };
+    auto sums = naturals()->rollingSum(3);
+    EXPECT_EQ(sums->memoiseNext(), 0 + 1 + 2);
+    EXPECT_EQ(sums->memoiseNext(), 1 + 2 + 3);
+    auto large = LazySequence<int>::create(2'000'000'000)->append(2'000'000'000)->rollingSum(2);
+    EXPECT_EQ(large->memoiseNext(), 4'000'000'000LL); // wider than the elements
+    auto means = naturals()->rollingMean(4);
+    EXPECT_DOUBLE_EQ(means->memoiseNext(), 1.5);
+    auto windows = naturals()->window(3);
+    windows->memoiseNext();
+    ArraySequence<int> second = windows->memoiseNext();
+    ASSERT_EQ(second.getSize(), 3u);
+    EXPECT_EQ(second[0], 1);
+    EXPECT_EQ(second[2], 3);
+    EXPECT_EQ((*naturals()->rollingMax(50))[Ordinal(10'000)], 10'049);
+
+    ArraySequence<int> data;
+    for (int value : {5, 1, 4, 2, 8, 3, 3, 0}) {
+        data.append(value);
+    }
+    auto values = LazySequence<int>::create(data);
+    auto minimums = values->rollingMin(3);
+    ASSERT_TRUE(minimums->getSize() == 6u);
+    const int expectedMin[] = {1, 1, 2, 2, 3, 0};
+    for (size_t i = 0; i < 6; i++) {
+        EXPECT_EQ((*minimums)[Ordinal(i)], expectedMin[i]);
+    }
+    EXPECT_FALSE(minimums->canMemoiseNext());
+
+    auto maximums = values->rollingMax(3); // windows pull by index, so sharing the parent doesn't shift them
+    const int expectedMax[] = {5, 4, 8, 8, 8, 3};
+    size_t count = 0;
+    while (auto next = maximums->tryMemoiseNext()) {
+        EXPECT_EQ(next.get(), expectedMax[count++]);
+    }
+    EXPECT_EQ(count, 6u);
+    EXPECT_EQ(maximums->get(Ordinal(2)), 8);
+
+    EXPECT_TRUE(values->rollingSum(9)->getSize() == 0u);
+    EXPECT_THROW(values->rollingSum(0), Exception);
+}
+
+// Multicast Tests
+TEST(LazySequenceTest, SiblingsReadEveryParentElementOnce) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    int computed = 0;
+    auto naturals = LazySequence<int>::create(1, [&computed](ArraySequence<int>& window) {
+        computed++;
+        return window[0] + 1;
+    }, initial);
+    auto doubled = naturals->map<int>([](int x) { return x * 2; });
+    auto negated = naturals->map<int>([](int x) { return -x; });
+    EXPECT_EQ(naturals->rollingSum(1)->memoiseNext(), naturals->map<int>([](int x) { return x; })->memoiseNext());
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(doubled->memoiseNext(), 2 * i); // the cached 0 is read as well
+    }
+    EXPECT_EQ(negated->memoiseNext(), 0);
+    EXPECT_EQ(negated->memoiseNext(), -1);
+    EXPECT_EQ(computed, 2);
+
+    for (int i = 3; i < 5'000; i++) {
+        doubled->memoiseNext();
+    }
+    EXPECT_EQ((*naturals)[Ordinal(2)], 2); // kept until the slower sibling reads it
+    EXPECT_EQ(negated->memoiseNext(), -2);
+    EXPECT_EQ(computed, 4'999);
+
+    negated = SharedPtr<LazySequence<int>>(); // a sibling which is gone doesn't hold the cache
+    for (int i = 0; i < 2'000; i++) {
+        doubled->memoiseNext();
+    }
+    EXPECT_THROW((*naturals)[Ordinal(2)], Exception);
+}
+
+TEST(LazySequenceTest, LaggingSiblingOfTrimmedParentThrows) {
+    ArraySequence<int> initial;
+    initial.append(0);
+    auto naturals = LazySequence<int>::create(1, [](ArraySequence<int>& window) { return window[0] + 1; }, initial);
+    auto fast = naturals->map<int>([](int x) { return x; });
+    auto slow = naturals->map<int>([](int x) { return x; });
+    EXPECT_EQ(slow->memoiseNext(), 0);
+
+    for (int i = 0; i < 10'000; i++) {
+        fast->memoiseNext();
+    }
+    EXPECT_GT(naturals->getMaterializedCount() - naturals->getMaterialized().getSize(), 1u); // the infinite parent can't replay
+    try {
+        slow->memoiseNext();
+        FAIL() << "a sibling behind the trimmed cache read an element";
+    } catch (Exception& ex) {
+        EXPECT_EQ(ex.getCode(), Exception::ErrorCode::CONSUMER_LAGGED);
+    }
+    EXPECT_EQ(fast->memoiseNext(), 10'000);
+}
+
 // Fold Tests
 TEST(LazySequenceTest, FoldLeft) {
     auto seq = LazySequence<int>::create(1)->append(2)->append(3)->append(4);